@@ -0,0 +1,96 @@
+#version 100
+
+precision highp float;
+
+// Default Raylib Shader Variables
+// =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+// Input vertex attributes (from vertex shader)
+varying vec2 fragTexCoord;
+varying vec4 fragColor;
+
+// Input uniform values
+// Tile index texture: one texel per cell, every layer stacked below the last
+// R, G: tile number in the tileset + 1 (low and high byte, 0 is no tile)
+// B: flip flags (1 horizontal, 2 vertical, 4 diagonal)
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+
+// Custom Variables
+// =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+// Most layers the shader will draw
+const int MAX_LAYERS = 8;
+
+// Map size in tiles, and layers in the index texture
+uniform highp vec2 map_size;
+uniform int layer_count;
+uniform float layer_opacity[MAX_LAYERS];
+
+// Tileset (tileset_size is the whole texture's, the tileset starts at tileset_origin when it's in the sprite atlas)
+uniform sampler2D tileset;
+uniform highp vec2 tileset_size;
+uniform highp vec2 tileset_origin;
+uniform highp vec2 tile_size;
+uniform highp float tileset_columns;
+uniform highp float tileset_margin;
+uniform highp float tileset_spacing;
+
+// Colour under every layer
+uniform vec4 background;
+
+// Functions
+// =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+// Is flag set in flags (both 0-7)
+bool hasFlag(float flags, float flag) {
+    return mod(floor(flags / flag), 2.) == 1.;
+}
+
+// Colour of one layer at a position in a cell (0-1), transparent if the cell is empty
+vec4 layerColour(int layer, vec2 cell, vec2 in_cell) {
+    highp vec2 index_uv = (cell + vec2(0., float(layer) * map_size.y) + 0.5) / vec2(map_size.x, map_size.y * float(layer_count));
+    vec4 index = texture2D(texture0, index_uv);
+
+    highp float tile = floor(index.r * 255. + 0.5) + floor(index.g * 255. + 0.5) * 256.;
+    if (tile < 0.5)
+        return vec4(0.);
+    tile -= 1.;
+
+    // Undo the tile's flips and rotation the same way DrawTexturePro draws them
+    float flags = floor(index.b * 255. + 0.5);
+    highp vec2 src = in_cell;
+    if (hasFlag(flags, 4.))
+        src = vec2(in_cell.y, 1. - in_cell.x);
+    if (hasFlag(flags, 1.))
+        src.x = 1. - src.x;
+    if (hasFlag(flags, 2.))
+        src.y = 1. - src.y;
+
+    // Nearest texel of the tile in the tileset
+    highp vec2 tile_pos = vec2(mod(tile, tileset_columns), floor(tile / tileset_columns));
+    highp vec2 texel = tileset_origin + tileset_margin + tile_pos * (tile_size + tileset_spacing) + min(floor(src * tile_size), tile_size - 1.) + 0.5;
+    return texture2D(tileset, texel / tileset_size);
+}
+
+// Main
+// =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
+
+void main() {
+    // Position on the map in tiles
+    highp vec2 map_pos = fragTexCoord * vec2(map_size.x, map_size.y * float(layer_count));
+    highp vec2 cell = floor(map_pos);
+    highp vec2 in_cell = map_pos - cell;
+
+    // Composite the layers in order
+    vec3 colour = background.rgb;
+    for (int i = 0; i < MAX_LAYERS; i++) {
+        if (i >= layer_count)
+            break;
+
+        vec4 layer = layerColour(i, cell, in_cell);
+        colour = mix(colour, layer.rgb, layer.a * layer_opacity[i]);
+    }
+
+    gl_FragColor = vec4(colour, 1.) * colDiffuse;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+// Helpers shared by the benchmarks in bench/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "core/GridTypes.hpp"
+#include "core/GridBuffer.hpp"
+#include "core/Level.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+// Prevent the optimizer from discarding benchmark results
+static volatile int64_t sink;
+
+// Load a level's object map (static grid plus the player at spawn) through the game's own loader
+inline bool loadBenchGrid(const char *path, GridBuffer<uint8_t> &grid)
+{
+    Level level;
+    if (!loadLevel(path, level))
+        return false;
+
+    grid.copyFrom(level.grid);
+    if (grid.inBounds(level.spawn_pos.x, level.spawn_pos.y))
+        grid(level.spawn_pos.x, level.spawn_pos.y) = GridVal_Player;
+
+    return true;
+}
+
+// Random level: each cell is a blocker with probability 1/density (deterministic for a given seed)
+inline void makeSyntheticGrid(GridBuffer<uint8_t> &grid, int w, int h, int density, uint32_t seed)
+{
+    grid.resize(w, h, GridVal_Empty);
+
+    for (std::size_t i = 0; i < grid.size(); i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        uint32_t r = (seed >> 16) % (uint32_t)density;
+
+        if (r < 4)
+            grid.data()[i] = uint8_t(GridVal_SolidBlock + r);
+    }
+}
+
+// Best average time per call over several repetitions (the minimum filters out scheduler noise)
+template <typename Fn>
+inline double timeNs(int iterations, Fn fn)
+{
+    double best = 1e300;
+    for (int rep = 0; rep < 7; rep++)
+    {
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < iterations; i++)
+            fn();
+        std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+        best = std::min(best, elapsed.count() / iterations);
+    }
+    return best;
+}
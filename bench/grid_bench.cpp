@@ -0,0 +1,176 @@
+// Grid layout microbenchmark
+//
+// Compares the old column-of-columns object map (std::vector<std::vector<uint8_t>>, indexed [x][y])
+// against the flat row-major GridBuffer on the operations the game performs every tick.
+//
+// Usage: grid_bench [map.json]   (defaults to assets/testmap2.json)
+
+#include <vector>
+
+#include "bench_common.hpp"
+
+using NestedGrid = std::vector<std::vector<uint8_t>>;
+
+// Old layout
+// ======================================================================================
+
+static NestedGrid toNested(GridBuffer<uint8_t> &grid)
+{
+    NestedGrid nested(grid.width(), std::vector<uint8_t>(grid.height()));
+    for (int x = 0; x < grid.width(); x++)
+        for (int y = 0; y < grid.height(); y++)
+            nested[x][y] = grid(x, y);
+    return nested;
+}
+
+static bool nestedMove(NestedGrid &m, int x, int y, int dx, int dy)
+{
+    if (x + dx < 0 || x + dx >= (int)m.size() || y + dy < 0 || y + dy >= (int)m.back().size())
+        return false;
+    if (m[x + dx][y + dy] != GridVal_Empty)
+        return false;
+
+    m[x + dx][y + dy] = m[x][y];
+    m[x][y] = GridVal_Empty;
+    return true;
+}
+
+// Full scan, as Map::update does every frame
+static int nestedCount(NestedGrid &m, uint8_t val)
+{
+    int count = 0;
+    for (int i = 0; i < (int)m.size(); i++)
+        for (int j = 0; j < (int)m[i].size(); j++)
+            count += m[i][j] == val;
+    return count;
+}
+
+// GridBuffer implementations (as App does it now)
+// ======================================================================================
+
+static bool flatMove(GridBuffer<uint8_t> &m, int x, int y, int dx, int dy)
+{
+    if (!m.inBounds(x + dx, y + dy))
+        return false;
+    if (m(x + dx, y + dy) != GridVal_Empty)
+        return false;
+
+    m(x + dx, y + dy) = m(x, y);
+    m(x, y) = GridVal_Empty;
+    return true;
+}
+
+static int flatCount(GridBuffer<uint8_t> &m, uint8_t val)
+{
+    // One contiguous run instead of one run per column
+    const uint8_t *cells = m.data();
+    int n = (int)m.size();
+    int count = 0;
+    for (int i = 0; i < n; i++)
+        count += cells[i] == val;
+    return count;
+}
+
+// Benchmarks
+// ======================================================================================
+
+static const int dirs[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+
+static void report(const char *name, double nested_ns, double flat_ns)
+{
+    printf("%-28s nested %12.1f ns   flat %12.1f ns   speedup %5.2fx\n", name, nested_ns, flat_ns, nested_ns / flat_ns);
+}
+
+int main(int argc, char const *argv[])
+{
+    const char *map_path = argc > 1 ? argv[1] : "assets/testmap2.json";
+
+    GridBuffer<uint8_t> flat;
+    if (!loadBenchGrid(map_path, flat))
+    {
+        printf("Could not load %s\n", map_path);
+        return 1;
+    }
+
+    NestedGrid nested = toNested(flat);
+
+    printf("%s: %dx%d cells\n\n", map_path, flat.width(), flat.height());
+
+    // Every empty cell is a slide origin; slide a lone cell from each one in all four directions
+    std::vector<int> origins;
+    for (int y = 0; y < flat.height(); y++)
+        for (int x = 0; x < flat.width(); x++)
+            if (flat(x, y) == GridVal_Empty)
+                origins.push_back(y * flat.width() + x);
+
+    // Full grid scan
+    // --------------------------------------------------------------------------------------
+    double nested_scan = timeNs(2000, [&]
+                                { sink += nestedCount(nested, GridVal_Player); });
+    double flat_scan = timeNs(2000, [&]
+                              { sink += flatCount(flat, GridVal_Player); });
+    report("full grid scan", nested_scan, flat_scan);
+
+    // Slides (infGridMove)
+    // --------------------------------------------------------------------------------------
+    double nested_slide = timeNs(20, [&]
+                                 {
+        for (int o : origins)
+            for (auto &d : dirs)
+            {
+                int x = o % flat.width(), y = o / flat.width();
+                uint8_t prev = nested[x][y];
+                nested[x][y] = GridVal_Player;
+                while (nestedMove(nested, x, y, d[0], d[1]))
+                {
+                    x += d[0];
+                    y += d[1];
+                }
+                nested[x][y] = prev;
+                sink += x + y;
+            } });
+    double flat_slide = timeNs(20, [&]
+                               {
+        for (int o : origins)
+            for (auto &d : dirs)
+            {
+                int x = o % flat.width(), y = o / flat.width();
+                uint8_t prev = flat(x, y);
+                flat(x, y) = GridVal_Player;
+                while (flatMove(flat, x, y, d[0], d[1]))
+                {
+                    x += d[0];
+                    y += d[1];
+                }
+                flat(x, y) = prev;
+                sink += x + y;
+            } });
+    report("all slides (4 dirs/cell)", nested_slide, flat_slide);
+
+    // Checkpoint copy
+    // --------------------------------------------------------------------------------------
+    NestedGrid nested_copy = nested;
+    GridBuffer<uint8_t> flat_copy;
+    flat_copy.copyFrom(flat);
+
+    double nested_copy_ns = timeNs(5000, [&]
+                                   {
+        nested_copy = nested;
+        sink += nested_copy[0][0]; });
+    double nested_fresh_ns = timeNs(5000, [&]
+                                    {
+        NestedGrid fresh = nested;
+        sink += fresh[0][0]; });
+    double flat_copy_ns = timeNs(5000, [&]
+                                 {
+        flat_copy.copyFrom(flat);
+        sink += flat_copy(0, 0); });
+    double flat_fresh_ns = timeNs(5000, [&]
+                                  {
+        GridBuffer<uint8_t> fresh = flat;
+        sink += fresh(0, 0); });
+    report("checkpoint copy (reuse)", nested_copy_ns, flat_copy_ns);
+    report("checkpoint copy (alloc)", nested_fresh_ns, flat_fresh_ns);
+
+    return 0;
+}
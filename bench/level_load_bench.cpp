@@ -0,0 +1,97 @@
+// Level loading benchmark
+//
+// Compares loading a level from Tiled JSON (parse, walk the layer and object lists, rasterize the
+// object layers) with opening the cooked binary level and copying its grid out. Cooks the JSON to a
+// temporary file first and checks both paths give the same level.
+//
+// Usage: level_load_bench [map.json]   (defaults to assets/testmap2.json)
+
+#include <cstring>
+#include <vector>
+
+#include "bench_common.hpp"
+
+#include "core/CookedLevel.hpp"
+
+int main(int argc, char **argv)
+{
+    const char *json_path = argc > 1 ? argv[1] : "assets/testmap2.json";
+    const char *cooked_path = "level_load_bench.ctl";
+
+    // Cook to disk
+    std::vector<uint8_t> bytes;
+    std::string error;
+    if (!cookLevelFile(json_path, bytes, error))
+    {
+        std::fprintf(stderr, "could not cook %s: %s\n", json_path, error.c_str());
+        return 1;
+    }
+
+    FILE *file = std::fopen(cooked_path, "wb");
+    if (!file)
+        return 1;
+    std::fwrite(bytes.data(), 1, bytes.size(), file);
+    std::fclose(file);
+
+    // Check both paths agree
+    Level json_level, cooked_level;
+    loadLevel(json_path, json_level);
+    loadCookedLevel(cooked_path, cooked_level);
+
+    if (json_level.grid.size() != cooked_level.grid.size() ||
+        std::memcmp(json_level.grid.data(), cooked_level.grid.data(), json_level.grid.size()) != 0 ||
+        json_level.spawn_pos.x != cooked_level.spawn_pos.x || json_level.spawn_pos.y != cooked_level.spawn_pos.y)
+    {
+        std::fprintf(stderr, "cooked level doesn't match the JSON level\n");
+        return 1;
+    }
+
+    std::printf("%s: %zu byte cooked file\n", json_path, bytes.size());
+
+    // JSON: what Map used to do at startup (parse everything, rasterize object layers, visit every tile)
+    double json_ns = timeNs(20, [&]()
+                     {
+                         cute_tiled_map_t *map = cute_tiled_load_map_from_file(json_path, NULL);
+                         Level level;
+                         initLevel(map, level);
+
+                         int64_t tiles = 0;
+                         for (cute_tiled_layer_t *layer = map->layers; layer; layer = layer->next)
+                         {
+                             if (std::string("objectgroup") == layer->type.ptr)
+                                 stampObjectLayer(layer, level);
+                             else if (std::string("tilelayer") == layer->type.ptr)
+                                 for (int i = 0; i < layer->data_count; i++)
+                                     tiles += layer->data[i] != 0;
+                         }
+                         sink = tiles;
+
+                         cute_tiled_free_map(map);
+                     });
+
+    // Cooked: open (mmap or one read), copy the grid out, visit every tile
+    double cooked_ns = timeNs(200, [&]()
+                              {
+                                  CookedLevel cooked;
+                                  cooked.open(cooked_path);
+
+                                  Level level;
+                                  cooked.toLevel(level);
+
+                                  int64_t tiles = 0;
+                                  const size_t cells = level.grid.size();
+                                  for (uint32_t l = 0; l < cooked.header().layer_count; l++)
+                                  {
+                                      const uint16_t *data = cooked.layerTiles(l);
+                                      for (size_t i = 0; i < cells; i++)
+                                          tiles += data[i] != 0;
+                                  }
+                                  sink = tiles;
+                              });
+
+    std::printf("json    %10.1f us/load\n", json_ns / 1000.0);
+    std::printf("cooked  %10.1f us/load  (%.0fx faster)\n", cooked_ns / 1000.0, json_ns / cooked_ns);
+
+    std::remove(cooked_path);
+    return 0;
+}
@@ -0,0 +1,101 @@
+// Headless simulation throughput benchmark
+//
+// Steps the core Simulation through a long, deterministic pseudo-random input stream and reports
+// ticks per second. Runs the same stream twice and checks both runs end in the same state.
+//
+// Usage: sim_bench [map.json] [ticks]   (defaults to assets/testmap2.json and 10 million ticks)
+
+#include <cstdlib>
+#include <vector>
+
+#include "bench_common.hpp"
+
+#include "core/Simulation.hpp"
+
+// Deterministic input stream: mostly idle ticks, with a slide or reset every few ticks
+static std::vector<SimInput> makeInputs(std::size_t count, uint32_t seed)
+{
+    std::vector<SimInput> inputs(count);
+
+    for (SimInput &input : inputs)
+    {
+        seed = seed * 1103515245u + 12345u;
+        uint32_t r = (seed >> 16) % 64;
+
+        if (r < 4)
+            input = SimInput(SimInput_Left + r);
+        else if (r == 4)
+            input = SimInput_Reset;
+        else
+            input = SimInput_None;
+    }
+
+    return inputs;
+}
+
+struct RunResult
+{
+    double seconds;
+    int64_t checksum;
+    int wins;
+    int deaths;
+};
+
+static RunResult run(Simulation &sim, const std::vector<SimInput> &inputs)
+{
+    RunResult result = {0, 0, 0, 0};
+    sim.reset();
+
+    Clock::time_point start = Clock::now();
+    for (SimInput input : inputs)
+    {
+        uint8_t events = sim.step(input);
+
+        result.deaths += (events & SimEvent_Died) != 0;
+
+        // Keep going after a win so the whole stream is simulated
+        if (events & SimEvent_Finished)
+        {
+            result.wins++;
+            sim.reset();
+        }
+
+        Vector2i pos = sim.getPlayerPos();
+        result.checksum = result.checksum * 31 + pos.x * 1000 + pos.y;
+    }
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    return result;
+}
+
+int main(int argc, char const *argv[])
+{
+    const char *map_path = argc > 1 ? argv[1] : "assets/testmap2.json";
+    std::size_t tick_count = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10'000'000;
+
+    Level level;
+    if (!loadLevel(map_path, level))
+    {
+        printf("Could not load %s\n", map_path);
+        return 1;
+    }
+
+    Simulation sim;
+    if (!sim.load(level))
+    {
+        printf("%s has no spawn\n", map_path);
+        return 1;
+    }
+
+    std::vector<SimInput> inputs = makeInputs(tick_count, 42);
+
+    RunResult first = run(sim, inputs);
+    RunResult second = run(sim, inputs);
+
+    printf("%s: %dx%d, %zu ticks\n", map_path, level.grid.width(), level.grid.height(), tick_count);
+    printf("  %.1f million ticks/s (%.1f ns/tick), %d wins, %d deaths\n",
+           tick_count / first.seconds / 1e6, first.seconds * 1e9 / tick_count, first.wins, first.deaths);
+    printf("  deterministic: %s\n", first.checksum == second.checksum && first.wins == second.wins ? "yes" : "NO");
+
+    return first.checksum == second.checksum ? 0 : 1;
+}
@@ -0,0 +1,140 @@
+// Slide kernel microbenchmark
+//
+// Compares three ways of answering "where does a slide from this cell stop":
+//  - step:     walk cell by cell through the GridBuffer (what infGridMove used to do through gridMove)
+//  - bitboard: GridBitboards::slide, one bit scan per 64 cells
+//  - table:    SlideTable::query, one precomputed lookup
+// on real levels and on synthetic ones of increasing size and sparsity.
+//
+// Usage: slide_bench [map.json ...]   (defaults to assets/testmap2.json and assets/realtestmap.json)
+
+#include <vector>
+
+#include "bench_common.hpp"
+
+#include "core/GridBitboards.hpp"
+#include "core/SlideTable.hpp"
+
+static const Vector2i dir_movs[4] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+
+// Step loop, the reference kernel
+static MoveInfo stepSlide(const GridBuffer<uint8_t> &grid, Vector2i pos, Direction dir)
+{
+    Vector2i mov = dir_movs[dir];
+
+    while (grid.inBounds(pos.x + mov.x, pos.y + mov.y) && grid(pos.x + mov.x, pos.y + mov.y) <= GridVal_Player)
+    {
+        pos.x += mov.x;
+        pos.y += mov.y;
+    }
+
+    GridVal blocked_by = GridVal_SolidBlock;
+    if (grid.inBounds(pos.x + mov.x, pos.y + mov.y))
+        blocked_by = (GridVal)grid(pos.x + mov.x, pos.y + mov.y);
+
+    return MoveInfo{pos, blocked_by};
+}
+
+static void runBench(const char *name, GridBuffer<uint8_t> &grid)
+{
+    GridBitboards bitboards;
+    bitboards.build(grid);
+
+    SlideTable table;
+    double build_ns = timeNs(3, [&]
+                             { table.build(&grid); });
+
+    // Every empty cell is a slide origin
+    std::vector<Vector2i> origins;
+    for (int y = 0; y < grid.height(); y++)
+        for (int x = 0; x < grid.width(); x++)
+            if (grid(x, y) <= GridVal_Player)
+                origins.push_back({x, y});
+
+    // Make sure all three agree before timing them
+    for (Vector2i o : origins)
+        for (int d = 0; d < 4; d++)
+        {
+            MoveInfo a = stepSlide(grid, o, (Direction)d);
+            MoveInfo b = bitboards.slide(o, (Direction)d);
+            MoveInfo c = table.query(o, (Direction)d);
+            if (a.final_pos.x != b.final_pos.x || a.final_pos.y != b.final_pos.y || a.blocked_by != b.blocked_by ||
+                a.final_pos.x != c.final_pos.x || a.final_pos.y != c.final_pos.y || a.blocked_by != c.blocked_by)
+            {
+                printf("%s: kernels disagree at (%d, %d) dir %d\n", name, o.x, o.y, d);
+                return;
+            }
+        }
+
+    int iterations = std::max(1, 2'000'000 / (int)(origins.size() * 4 + 1));
+    double slides = (double)origins.size() * 4;
+
+    double step_ns = timeNs(iterations, [&]
+                            {
+        for (Vector2i o : origins)
+            for (int d = 0; d < 4; d++)
+                sink += stepSlide(grid, o, (Direction)d).final_pos.x; }) / slides;
+
+    double bitboard_ns = timeNs(iterations, [&]
+                                {
+        for (Vector2i o : origins)
+            for (int d = 0; d < 4; d++)
+                sink += bitboards.slide(o, (Direction)d).final_pos.x; }) / slides;
+
+    double table_ns = timeNs(iterations, [&]
+                             {
+        for (Vector2i o : origins)
+            for (int d = 0; d < 4; d++)
+                sink += table.query(o, (Direction)d).final_pos.x; }) / slides;
+
+    printf("%-34s %5dx%-6d step %7.2f ns  bitboard %6.2f ns (%5.2fx)  table %5.2f ns (%6.2fx)  table build %8.1f us\n",
+           name, grid.width(), grid.height(), step_ns, bitboard_ns, step_ns / bitboard_ns, table_ns, step_ns / table_ns, build_ns / 1000.0);
+}
+
+int main(int argc, char const *argv[])
+{
+    std::vector<const char *> maps;
+    for (int i = 1; i < argc; i++)
+        maps.push_back(argv[i]);
+    if (maps.empty())
+        maps = {"assets/testmap2.json", "assets/realtestmap.json"};
+
+    printf("Average time per slide\n\n");
+
+    // Real levels
+    for (const char *path : maps)
+    {
+        GridBuffer<uint8_t> grid;
+        if (!loadBenchGrid(path, grid))
+        {
+            printf("Could not load %s\n", path);
+            continue;
+        }
+        runBench(path, grid);
+    }
+
+    // Synthetic levels (density N = one blocker every N cells on average)
+    struct Synthetic
+    {
+        int w, h, density;
+    };
+    const Synthetic synthetics[] = {
+        {33, 460, 10},
+        {33, 460, 100},
+        {33, 10000, 50},
+        {64, 4096, 200},
+        {200, 2000, 400},
+    };
+
+    for (const Synthetic &syn : synthetics)
+    {
+        GridBuffer<uint8_t> grid;
+        makeSyntheticGrid(grid, syn.w, syn.h, syn.density, 1234);
+
+        char name[64];
+        snprintf(name, sizeof(name), "synthetic (1 in %d blocked)", syn.density);
+        runBench(name, grid);
+    }
+
+    return 0;
+}
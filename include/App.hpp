@@ -1,13 +1,33 @@
 #pragma once
 #include "main.hpp"
 
+// Resolution the background shader is rendered at, as a fraction of the screen's (see App::bal_texture)
+enum BackgroundQuality
+{
+    BackgroundQuality_Full,
+    BackgroundQuality_Half,
+    BackgroundQuality_Quarter,
+    BackgroundQuality_Eighth,
+
+    BackgroundQuality_Count
+};
+
 // Main Application Class
 class App
 {
 private:
     // App render texture
     //--------------------------------------------------------------------------------------
+
+    // Everything is drawn in screen_w x screen_h coordinates, scaled down to the target's size by render_scale
     RenderTexture2D target;
+    float render_scale;
+
+    // Re-create target at a fraction of screen_w x screen_h
+    void setRenderScale(float scale);
+
+    // Camera that scales screen coordinates to the target
+    Camera2D getRenderCamera();
 
     // World Values
     //--------------------------------------------------------------------------------------
@@ -17,28 +37,90 @@ private:
 
     // Map and map-related values
     //--------------------------------------------------------------------------------------
+
+    // nullptr until the level has loaded
     std::unique_ptr<Map> map;
 
-    // Grid-based Map
+    // Campaign levels, in order (from levels.txt), and the one being played
+    LevelRegistry level_registry;
+    size_t level_index;
+
+    // Loads levels in the background: the first one while the menu is drawn, then the one after whichever is played
+    std::unique_ptr<MapLoader> map_loader;
+
+    // The next level, prefetched while this one is played and uploaded on the win screen
+    // (with map, at most two levels are ever resident)
+    std::unique_ptr<MapData> next_map_data;
+    std::unique_ptr<Map> next_map;
+
+    // Upload the first level and start the simulation on it
+    void finishMapLoad();
+
+    // Make new_map the level being played (map_data is what it was loaded from)
+    void useMap(std::unique_ptr<Map> new_map, const MapData &map_data);
+
+    // Start loading the level after the current one in the background (if there is one)
+    void prefetchNextLevel();
+
+    // Swap in the prefetched next level and start playing it
+    void advanceLevel();
+
+#ifdef CATTOWER_HOT_RELOAD
+    // Level hot reload (native dev builds)
     //--------------------------------------------------------------------------------------
-    Direction player_orient;
-    Direction player_checkp_orient;
-    Direction player_reset_map_orient;
 
-    std::vector<std::vector<uint8_t>> object_map;
-    std::vector<std::vector<uint8_t>> object_checkp_map;
-    std::vector<std::vector<uint8_t>> object_reset_map;
+    // How often the level file is checked, in seconds
+    static constexpr double level_watch_interval = 0.5;
 
-    // Set screen w and h
-    float screen_w;
-    float screen_h;
+    // Modification time of the level's Tiled JSON when it was last loaded
+    std::filesystem::file_time_type level_file_time;
+    double level_watch_time;
+
+    // Start watching the current level's file
+    void watchLevelFile();
+
+    // Reload the level if its file has changed (checked every level_watch_interval)
+    void pollLevelReload();
+
+    // Apply the edited level in place: changed tiles are re-drawn and changed cells re-stamped,
+    // the player's position and the timer are kept
+    void reloadLevel();
+#endif
+
+    // Gameplay rules and grid state (headless, see core/Simulation.hpp)
+    //--------------------------------------------------------------------------------------
+    Simulation sim;
+
+    // Shortest route through every checkpoint, for the par time on the win screen
+    Solution level_solution;
+
+    // Replays
+    //--------------------------------------------------------------------------------------
+
+    // Identifies the level in replays, so runs can't be verified against a different one
+    uint64_t level_hash;
+
+    // Records every step of the current run
+    ReplayRecorder replay_recorder;
+
+    // Write the finished run to replays/ (native builds only)
+    void saveRunReplay();
 
-    // Counter for speedrunning
+    // Player input
     //--------------------------------------------------------------------------------------
 
-    float time_counter;
+    // How many key presses can be waiting for the simulation at once
+    static constexpr size_t input_buffer_depth = 4;
 
-    float time_limit;
+    // Key presses waiting to be applied, one slide each
+    InputQueue input_queue;
+
+    // Queue this frame's key presses (stamped with GetTime())
+    void pollInput();
+
+    // Set screen w and h
+    float screen_w;
+    float screen_h;
 
     // Debug GUI Values
     //--------------------------------------------------------------------------------------
@@ -46,6 +128,12 @@ private:
     bool render_colliders;
     bool render_positions;
 
+    // Timing/debug overlay (toggled with F1)
+    bool render_debug_overlay;
+
+    // Draw the debug overlay on top of everything else
+    void drawDebugOverlay();
+
     // Audio
     //--------------------------------------------------------------------------------------
 
@@ -59,7 +147,26 @@ private:
     plt::GameState game_state;
     plt::GameState prev_game_state;
 
-    std::chrono::system_clock::time_point last_frame;
+    std::chrono::steady_clock::time_point last_frame;
+
+    // Fixed-timestep simulation
+    //--------------------------------------------------------------------------------------
+
+    // Longest frame the simulation will try to catch up on (avoids a burst of ticks after a stall)
+    static constexpr double max_frame_time = 0.25;
+
+    // Real time not yet consumed by simulation ticks
+    double sim_accumulator;
+
+    // How far the current frame is between the last two ticks (0-1), for interpolation
+    float render_alpha;
+
+    // Measured tick and frame rates (updated once a second)
+    std::chrono::steady_clock::time_point rate_window_start;
+    int rate_window_ticks;
+    int rate_window_frames;
+    float measured_tick_rate;
+    float measured_frame_rate;
 
     // Fonts
     //--------------------------------------------------------------------------------------
@@ -71,21 +178,45 @@ private:
     // Textures
     //--------------------------------------------------------------------------------------
 
-    // Default Texture
-    Texture2D ttt_tex;
-    Texture2D cat_tex;
+    // Every sprite (tileset, cat, spikes) in one texture, so they all batch together
+    SpriteAtlas sprite_atlas;
+
+    // Rendering quality
+    //--------------------------------------------------------------------------------------
+
+    // Steps through the quality tiers (quality_tiers in App.cpp) from how long frames take
+    // (F3 cycles between it and each tier fixed)
+    FrameGovernor quality_governor;
 
-    void loadTexFromImg(std::string img_file, Texture2D *tex);
+    // Tier whose settings are applied, -1 before the first
+    int quality_tier;
+
+    // Apply a quality tier's background, shadow, render target and particle settings
+    void applyQualityTier(int tier);
 
     // Shaders
     //--------------------------------------------------------------------------------------
 
     // Balatro Background Shader
+    // The swirl is smooth, so it's rendered into bal_texture at a fraction of the screen's resolution and upscaled
+    // (the shader works in texture coordinates, so its pixel_filter looks the same at any scale)
     Shader bal_shader;
     RenderTexture2D bal_texture;
     float delta_t_bal;
     std::map<std::string, int> bal_shader_uni;
 
+    // 1x1 white texture the shader pass is drawn with, so fragTexCoord covers 0-1
+    Texture2D bal_source;
+
+    // Resolution tier bal_texture is at (picked by the rendering quality tier)
+    BackgroundQuality bal_quality;
+
+    // Re-create bal_texture for a quality tier
+    void setBackgroundQuality(BackgroundQuality quality);
+
+    // Render the background shader into bal_texture (before the app target is bound)
+    void renderBackground();
+
     Shader chromatic_abb_shader;
     std::map<std::string, int> chrom_shader_uni;
 
@@ -111,12 +242,15 @@ private:
     // Initialize systems and attatch them to the ECS world
     void initFlecsSystems();
 
+    // Systems run once per simulation tick (the rest run once per rendered frame)
+    flecs::system player_system;
+    flecs::system map_pos_system;
+
     // Player system
     //--------------------------
     // Get input from player
-    void PlayerSystem(flecs::entity e, plt::Player &player);
+    void PlayerSystem(flecs::entity e);
     float player_vert_progress; // Player Vertical Progress
-    Vector2i getPlayerPos();
 
     // Particle system
     //--------------------------
@@ -126,29 +260,29 @@ private:
     //--------------------------
 
     // Map position system
-    void MapPosSystem();
+    void MapPosSystem(float delta_time);
     Rectangle map_dest;
 
+    // map_dest as of the previous tick, map_dest is drawn interpolated between the two
+    Rectangle prev_map_dest;
+
+    // Where the map is drawn this frame (between prev_map_dest and map_dest)
+    Rectangle getDrawMapDest();
+
     // Render system
     //--------------------------
     // Render the world after all updates
     void RenderSystem();
 
-    // Moves an entity at pos by mov, then returns if the movement was successful (ie. not blocked)
-    bool gridMove(Vector2i pos, Vector2i mov);
-
-    // Move in a specified direction infinitely until blocked, returning the info of where it stopped and what it was blocked by
-    MoveInfo infGridMove(Vector2i pos, Direction dir);
-
-    // Check what type of entity is at the specified location
-    GridVal gridCheck(Vector2i pos);
-
     void gameReset();
 
 public:
     App(RenderTexture2D target, Vector2 screen_siz);
     ~App();
 
-    // Update the application (audio will be updated more often than display)
+    // The target the app renders into (re-created when the render scale changes)
+    RenderTexture2D getTarget();
+
+    // Update the application (simulation ticks at a fixed rate, rendering and audio run every frame)
     void update();
 };
\ No newline at end of file
@@ -3,25 +3,115 @@
 
 struct TilesetInfo
 {
-    cute_tiled_tileset_t info;
+    CookedTileset info;
     Texture2D tex;
+
+    // Where the tileset's image starts in tex (it's only part of tex when it's drawn from the sprite atlas)
+    Vector2 origin;
+
+    // tex is the sprite atlas' (not the map's to unload)
+    bool in_atlas;
+};
+
+// Where a tile GID is drawn from, see Map::tile_lookup
+struct TileLookup
+{
+    // Index into tilesets_info, -1 if no tileset has this GID
+    int32_t tileset;
+
+    // The tile's rect in the tileset texture (or the atlas)
+    Rectangle src;
 };
 
 struct TileLayerInfo
 {
-    RenderTexture2D tex;
+    // Tile GIDs and flip flags, row by row (copied from the cooked level so tiles can be edited)
+    std::vector<uint16_t> tiles;
+    std::vector<uint8_t> flags;
+
     float opacity;
 };
 
+// How the map's tile layers are drawn
+enum MapRenderMode
+{
+    // Rasterized into chunk textures as they come into view
+    MapRenderMode_Chunks,
+
+    // Looked up per pixel by shaders/tilemap.fs from a tile index texture (needs a single tileset)
+    MapRenderMode_Shader
+};
+
+// A square of the map rasterized into a slot of the chunk texture, see Map::chunk_pool
+struct MapChunk
+{
+    // Where the chunk is drawn in Map::chunk_texture
+    Rectangle slot;
+
+    // Which chunk of the map is in tex, -1 if none
+    int32_t chunk_index;
+
+    // Frame the chunk was last needed on (least recently used chunks are evicted first)
+    uint64_t last_used;
+
+    // Tiles in the chunk have changed since it was rasterized
+    bool dirty;
+};
+
+// How long the map took to load, in milliseconds (see Map::getLoadStats)
+struct MapLoadStats
+{
+    // Done by MapLoader (on the loading thread when there is one)
+    double level_ms;
+    double tilesets_ms;
+    double solve_ms;
+
+    // Uploading to the GPU, on the main thread
+    double upload_ms;
+
+    double total_ms;
+};
+
+// Chunk streaming counters (see Map::getChunkStats)
+struct MapChunkStats
+{
+    // Chunks resident in the pool, and the most it will hold
+    uint32_t resident;
+    uint32_t capacity;
+
+    // Chunks drawn last frame
+    uint32_t drawn;
+
+    // Chunks rasterized and evicted since the map was loaded, and the tiles it took
+    uint32_t rasterized;
+    uint32_t evicted;
+    uint64_t tiles_drawn;
+};
+
+// Map drawing work done in the current frame, to check how much is redrawn (see Map::getFrameStats)
+struct MapFrameStats
+{
+    // Draw calls (each chunk blit, sprite and rasterize batch counts as one)
+    uint32_t draw_calls;
+
+    // Pixels written, to the app target and to chunk textures
+    uint64_t pixels;
+
+    // Chunks rasterized this frame
+    uint32_t rasterized;
+};
+
 class Map
 {
 private:
     // Map
     //--------------------------------------------------------------------------------------
-    cute_tiled_map_t *map;
-    std::vector<std::vector<uint8_t>> *object_map;
+
     flecs::world *ecs_world;
 
+    // Static grid of the level (collision, damage, checkpoints, finish and spawn)
+    Level level;
+
     // Map Info
     //--------------------------------------------------------------------------------------
     int map_w;
@@ -30,47 +120,149 @@ private:
     int tile_w;
     int tile_h;
 
-    // Map render target(s)
-    //--------------------------------------------------------------------------------------
-
-    // Map portion drawn behind everything else
-    RenderTexture2D map_target;
+    // Load timings
+    MapLoadStats load_stats;
 
     // Map Tilesets
     //--------------------------------------------------------------------------------------
     std::vector<TilesetInfo> tilesets_info;
-    
+
+    // Tileset and src rect of every GID, indexed by GID (built once in loadTilesets)
+    std::vector<TileLookup> tile_lookup;
+
     // Map Tile Layers
     //--------------------------------------------------------------------------------------
     std::vector<TileLayerInfo> tilelayers_info;
 
+    // Map chunks
+    //--------------------------------------------------------------------------------------
+
+    // Chunks are chunk_tiles x chunk_tiles tiles, with every tile layer composited into one texture
+    static constexpr int chunk_tiles = 32;
+
+    // Chunks share one texture, chunk_pool_columns slots square
+    static constexpr int chunk_pool_columns = 4;
+
+    // Most chunks kept at once (a 1280x720 view needs 8 at the game's 2.5x zoom)
+    static constexpr size_t max_resident_chunks = chunk_pool_columns * chunk_pool_columns;
+
+    // Map size in chunks
+    int chunks_x;
+    int chunks_y;
+
+    // Every resident chunk in one render texture, so drawing the visible chunks is a single batch
+    // (allocated when the first chunk is needed)
+    RenderTexture2D chunk_texture;
+
+    // Rasterized chunks, given slots as they're first needed
+    std::vector<MapChunk> chunk_pool;
+
+    // Pool slot holding each chunk of the map (-1 if it isn't resident), indexed by chunk
+    std::vector<int32_t> chunk_slots;
+
+    // Counts frames, for the LRU
+    uint64_t frame_count;
+
+    MapChunkStats chunk_stats;
+    MapFrameStats frame_stats;
+
+    // Tilemap shader
+    //--------------------------------------------------------------------------------------
+
+    MapRenderMode render_mode;
+
+    // Every tile layer has a map_w x map_h block in the index texture, stacked top to bottom
+    // (RG: tile number in the tileset + 1, B: flip flags)
+    Texture2D index_tex;
+
+    // The shader can only draw maps that use one tileset
+    bool shader_supported;
+
+    Shader tilemap_shader;
+    std::map<std::string, int> tilemap_shader_uni;
+
     // Methods
     //--------------------------------------------------------------------------------------
 
-    // Load tileset textures
-    void loadTilesets();
+    // Upload tileset textures (or find them in the sprite atlas) and build the GID lookup table
+    void loadTilesets(MapData &data, const SpriteAtlas &atlas);
 
     // Load map dimensions
-    void loadMapDimensions();
+    void loadMapDimensions(const CookedLevel &cooked);
 
     // Parse through all map layers
-    void parseMapLayers();
+    void parseMapLayers(const MapData &data);
 
     // Parse a single tile layer
-    void parseTileLayer(cute_tiled_layer_t *layer);
+    void parseTileLayer(const CookedLevel &cooked, uint32_t layer_index);
 
-    // Parse a single object layer
-    void parseObjLayer(cute_tiled_layer_t *layer);
+    // Load the static grid (collision, damage, checkpoints, finish) and add the player at spawn
+    void parseObjLayers(const Level &loaded_level);
+
+    // Range of chunks (inclusive) that land inside view when the map is drawn at dest
+    void visibleChunks(Rectangle dest, Rectangle view, int &first_x, int &first_y, int &last_x, int &last_y);
+
+    // Make a chunk resident and up to date, rasterizing it into the least recently used slot if it isn't resident
+    void requestChunk(int chunk_x, int chunk_y);
+
+    // Draw every tile layer of a chunk into its slot
+    void rasterizeChunk(MapChunk &chunk, int chunk_x, int chunk_y);
+
+    // Free the chunk texture
+    void unloadChunks();
+
+    // Load the tilemap shader and upload the tile layers to the index texture
+    void loadTilemapShader();
+
+    // Index texel for a tile
+    void encodeTile(uint16_t gid, uint8_t flags, uint8_t texel[4]);
+
+    // Draw the map with the tilemap shader
+    void drawTilemapShader(Rectangle dest, Rectangle view);
 
 public:
-    // Constructor
-    Map(flecs::world *ecs_world, std::vector<std::vector<uint8_t>> *object_map);
+    // Constructor (uploads data prepared by MapLoader, the tileset images are taken)
+    // Tilesets in the sprite atlas are drawn from it, atlas must outlive the map
+    Map(flecs::world *ecs_world, MapData &data, const SpriteAtlas &atlas);
 
     // Destructor
     ~Map();
 
-    // Draw the map texture to the screen
-    void update(Direction player_o, Texture2D player_tex);
+    // Stream in the chunks needed to draw the map at dest (in target space) with view visible
+    void update(Rectangle dest, Rectangle view);
+
+    // Draw the visible chunks of the map at dest, and the player (player_src in player_tex) on top
+    void draw(Rectangle dest, Rectangle view, Direction player_o, Texture2D player_tex, Rectangle player_src, Vector2i player_pos);
+
+    // Mark a w x h block of tiles at (x, y) as changed, only the chunks holding them are re-rasterized
+    void invalidateTiles(int x, int y, int w, int h);
 
-    RenderTexture2D getRenderTexture();
-};
\ No newline at end of file
+    // Change one tile, redrawing only what it touches (a single texel in shader mode)
+    void setTile(uint32_t layer_index, int x, int y, uint16_t gid, uint8_t flags);
+
+    // Update the tile layers to a re-cooked version of the level, only re-drawing tiles that changed
+    // Returns how many changed, or -1 if the layers, tilesets or size changed (those need a full reload)
+    int reloadTiles(const CookedLevel &cooked);
+
+    // Replace the level's static grid (after re-stamping the simulation with it)
+    void setLevel(const Level &new_level);
+
+    // Switch how the map is drawn, returns false if the map can't be drawn that way
+    bool setRenderMode(MapRenderMode mode);
+    MapRenderMode getRenderMode();
+
+    // Returns the level's static grid
+    const Level &getLevel();
+
+    // Returns the map's size in pixels (before scaling)
+    Vector2 getPixelSize();
+
+    // Returns how long loading the map took
+    const MapLoadStats &getLoadStats();
+
+    // Returns the chunk streaming counters
+    const MapChunkStats &getChunkStats();
+
+    // Returns the drawing work done so far this frame
+    const MapFrameStats &getFrameStats();
+};
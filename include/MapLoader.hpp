@@ -0,0 +1,120 @@
+#pragma once
+#include "main.hpp"
+
+// Web builds only get a loading thread when they're built with pthreads (CATTOWER_WEB_PTHREADS),
+// otherwise the loader runs one stage per frame on the main thread
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+#define CATTOWER_THREADED_LOADING 1
+#else
+#define CATTOWER_THREADED_LOADING 0
+#endif
+
+// Everything a map needs that doesn't touch the GPU (prepared by MapLoader, uploaded by Map)
+struct MapData
+{
+    // Cooked level data (see core/CookedLevel.hpp)
+    CookedLevel cooked;
+
+    // Decoded tileset images, one per cooked tileset (Map takes them to upload)
+    // Tilesets packed in the sprite atlas aren't decoded, their image is empty
+    std::vector<Image> tileset_images;
+
+    // Static grid of the level
+    Level level;
+
+    // Shortest route through every checkpoint, for the par time on the win screen
+    Solution solution;
+
+    // Identifies the level in replays
+    uint64_t level_hash;
+
+    // Time each stage took, in milliseconds
+    double level_ms;
+    double tilesets_ms;
+    double solve_ms;
+
+    MapData();
+    ~MapData();
+
+    MapData(const MapData &) = delete;
+    MapData &operator=(const MapData &) = delete;
+};
+
+// Solver settings for the par time shown in game: the route through every checkpoint, like the levels
+// are meant to be played (a spawn-to-finish dash can skip them and set an unfair par)
+SolverOptions parSolverOptions();
+
+// Loading stages, in order
+enum MapLoadStage
+{
+    MapLoadStage_Idle,
+
+    // Open the cooked level (or cook the Tiled JSON)
+    MapLoadStage_Level,
+
+    // Decode the tileset images
+    MapLoadStage_Tilesets,
+
+    // Copy out the static grid and hash it
+    MapLoadStage_Grid,
+
+    // Solve the level for its par time
+    MapLoadStage_Solve,
+
+    MapLoadStage_Done,
+    MapLoadStage_Failed
+};
+
+// Loads a level's CPU-side data off the main thread
+class MapLoader
+{
+private:
+    std::string cooked_path;
+    std::string json_path;
+
+    std::unique_ptr<MapData> data;
+
+    // Sprite atlas the map will draw from, tilesets already in it are skipped (may be null)
+    const SpriteAtlas *atlas;
+
+    // MapLoadStage being run (written by the worker, read by the main thread)
+    std::atomic<int> stage;
+
+    // The last load failed (kept after take() resets the stage, until the next start())
+    bool failed;
+
+#if CATTOWER_THREADED_LOADING
+    std::thread worker;
+#endif
+
+    // Run one stage of loading, returns the stage after it
+    MapLoadStage runStage(MapLoadStage current);
+
+    // Wait for the worker to finish
+    void join();
+
+public:
+    // atlas must outlive the loader, it's read from the loading thread
+    MapLoader(const SpriteAtlas *atlas);
+    ~MapLoader();
+
+    // Start loading a level, cooking the Tiled JSON in memory if there's no cooked file
+    void start(const std::string &cooked_path, const std::string &json_path);
+
+    // Call once a frame, returns true once loading has finished (or failed)
+    // (single-threaded builds run the next stage here)
+    bool poll();
+
+    MapLoadStage getStage() const;
+
+    // How far through loading (0-1)
+    float getProgress() const;
+
+    bool isLoading() const;
+
+    // Did the last load fail (stays true once its result has been taken)
+    bool hasFailed() const;
+
+    // Take the loaded data (nullptr if loading failed or hasn't finished)
+    std::unique_ptr<MapData> take();
+};
@@ -21,9 +21,17 @@ class ParticleSystem
 private:
     std::vector<Particle> particles;
 
+    // Particles each system spawns at full density
+    static constexpr int base_particle_count = 10;
+
+    // Fraction of base_particle_count new systems spawn (lowered at low quality tiers)
+    static float density;
+
 public:
     ParticleSystem(Vector2 &pos);
 
+    static void setDensity(float density);
+
     void update();
     bool draw();
 };
\ No newline at end of file
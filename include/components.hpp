@@ -6,19 +6,9 @@ namespace plt
     //--------------------------------------------------------------------------------------
     // Player
     //--------------------------------------------------------------------------------------
-    enum PlayerMvnmtState : uint8_t
-    {
-        PlayerMvnmtState_Left,
-        PlayerMvnmtState_Right,
-        PlayerMvnmtState_Up,
-        PlayerMvnmtState_Down,
-        PlayerMvnmtState_Idle
-    };
-
+    // Tag for the player entity (where it is and how it moves lives in the Simulation)
     struct Player
     {
-        // Movement state
-        PlayerMvnmtState move_state;
     };
 
     //--------------------------------------------------------------------------------------
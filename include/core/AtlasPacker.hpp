@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// A sprite's place in an atlas, in pixels
+struct PackedRect
+{
+    int32_t x;
+    int32_t y;
+    int32_t w;
+    int32_t h;
+};
+
+// Pack sprites into one atlas with a shelf packer
+//
+// rects come in with w and h set and go out with x and y filled in. Sprites are placed tallest first
+// (ties by width, then by index) on shelves as wide as the widest sprite, so the same sprites always
+// pack the same way, whether the cooker or the game does it. padding empty pixels are left between
+// sprites (not around the atlas' edges).
+//
+// Returns false if a sprite is wider or the atlas would be taller than max_size.
+bool packAtlas(std::vector<PackedRect> &rects, int32_t padding, int32_t max_size, int32_t &atlas_w, int32_t &atlas_h);
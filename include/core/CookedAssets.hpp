@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+
+// Cooked sprite atlas and font file formats
+//
+// Written by cattower_cook at build time and loaded by the game in one read, so startup skips TrueType
+// rasterization and PNG's inflate. The atlas' pixels are stored as QOI, which raylib decodes several
+// times faster than PNG at about the same size. Like cooked levels, all offsets are from the start of the file
+// and integers are little-endian.
+//--------------------------------------------------------------------------------------
+
+static const uint32_t cooked_asset_version = 3;
+
+// Font (.ctf): header, glyph table, then the glyph atlas as a gray+alpha PNG
+//
+// Glyph metrics match what raylib's LoadFontEx() produces for the same size and glyph count, so text
+// lays out identically. Each glyph's rectangle has glyph_padding pixels of empty space around it in
+// the atlas, as raylib expects.
+//--------------------------------------------------------------------------------------
+
+static const char cooked_font_magic[4] = {'C', 'T', 'F', 'N'};
+
+struct CookedFontHeader
+{
+    char magic[4];
+    uint32_t version;
+
+    int32_t base_size;
+    int32_t glyph_count;
+    int32_t glyph_padding;
+
+    uint32_t glyph_offset;
+
+    uint32_t atlas_offset;
+    uint32_t atlas_size;
+};
+
+struct CookedGlyph
+{
+    int32_t value;
+    int32_t offset_x;
+    int32_t offset_y;
+    int32_t advance_x;
+
+    // Glyph rectangle in the atlas
+    float rec_x;
+    float rec_y;
+    float rec_w;
+    float rec_h;
+};
+
+// Sprite atlas (.cta): header, sprite table, then the RGBA8 pixels as a QOI image
+//
+// Every sprite image the game draws packed into one texture (see core/AtlasPacker.hpp), so sprites,
+// tiles and rectangles all batch into the same draw call. Sprites are named by their image's file
+// name without the extension. The atlas always has a small opaque white sprite (atlas_white_sprite)
+// that shapes are drawn with.
+//--------------------------------------------------------------------------------------
+
+static const char cooked_atlas_magic[4] = {'C', 'T', 'A', 'T'};
+
+// Name and size of the built-in white sprite
+static const char atlas_white_sprite[] = "white";
+static const int32_t atlas_white_size = 4;
+
+// Empty pixels between sprites
+static const int32_t atlas_padding = 2;
+
+// Largest atlas the cooker (or the game's fallback) will make
+static const int32_t atlas_max_size = 4096;
+
+struct CookedAtlasHeader
+{
+    char magic[4];
+    uint32_t version;
+
+    uint32_t width;
+    uint32_t height;
+
+    uint32_t sprite_count;
+    uint32_t sprites_offset;
+
+    // QOI image of the width * height RGBA8 atlas, and its size in bytes
+    uint32_t pixels_offset;
+    uint32_t pixels_size;
+};
+
+struct CookedAtlasSprite
+{
+    // Nul-terminated
+    char name[64];
+
+    // Sprite rectangle in the atlas
+    int32_t x;
+    int32_t y;
+    int32_t w;
+    int32_t h;
+};
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "cute/cute_tiled.h"
+
+#include "core/GridTypes.hpp"
+#include "core/Level.hpp"
+
+// Cooked level file format
+//
+// Everything the game needs from a Tiled map, laid out so the runtime can map (or read) the file and
+// use it in place: a header, a tileset table, a tile layer table, then the data blocks they point to.
+// Tile layers are packed uint16 GIDs (0 = empty) with an optional byte of flip flags per tile, and the
+// object layers are already rasterized into the level grid. All offsets are from the start of the file
+// and every block is 4-byte aligned. Integers are little-endian.
+//--------------------------------------------------------------------------------------
+
+static const char cooked_level_magic[4] = {'C', 'T', 'L', 'V'};
+static const uint32_t cooked_level_version = 1;
+
+// Tile flip flags (per tile, in a layer's flags block)
+enum CookedTileFlag : uint8_t
+{
+    CookedTileFlag_FlipH = 1 << 0,
+    CookedTileFlag_FlipV = 1 << 1,
+    CookedTileFlag_FlipDiagonal = 1 << 2,
+};
+
+struct CookedLevelHeader
+{
+    char magic[4];
+    uint32_t version;
+
+    // Total file size, to catch truncated files
+    uint32_t file_size;
+
+    // Map size in cells and cell size in pixels
+    int32_t width;
+    int32_t height;
+    int32_t tile_w;
+    int32_t tile_h;
+
+    // Player spawn cell (always inside the map, levels without one aren't cooked)
+    int32_t spawn_x;
+    int32_t spawn_y;
+
+    uint32_t tileset_count;
+    uint32_t tileset_offset;
+
+    uint32_t layer_count;
+    uint32_t layer_offset;
+
+    // width * height GridVal bytes
+    uint32_t grid_offset;
+};
+
+struct CookedTileset
+{
+    int32_t firstgid;
+    int32_t tilecount;
+    int32_t columns;
+
+    int32_t tile_w;
+    int32_t tile_h;
+    int32_t margin;
+    int32_t spacing;
+
+    int32_t image_w;
+    int32_t image_h;
+
+    // Image file name (no directories), null terminated
+    char image[92];
+};
+
+struct CookedTileLayer
+{
+    // Layer name, null terminated
+    char name[48];
+    float opacity;
+
+    // width * height uint16 GIDs
+    uint32_t tiles_offset;
+
+    // width * height CookedTileFlag bytes (0 if no tile in the layer is flipped)
+    uint32_t flags_offset;
+
+    uint32_t reserved;
+};
+
+// Cooking
+//--------------------------------------------------------------------------------------
+
+// Cook a parsed Tiled map, returns false (with a reason in error) if it can't be represented
+bool cookLevel(const cute_tiled_map_t *map, std::vector<uint8_t> &out, std::string &error);
+
+// Cook a Tiled JSON map file
+bool cookLevelFile(const char *json_path, std::vector<uint8_t> &out, std::string &error);
+
+// Loading
+//--------------------------------------------------------------------------------------
+
+// A cooked level, used in place
+//
+// open() maps the file where the platform supports it and otherwise reads it with a single read, then
+// checks the header and that every block lies inside the file. After that the accessors just point
+// into the file's bytes.
+class CookedLevel
+{
+private:
+    // Mapped file (if mapped)
+    void *mapping;
+    size_t mapping_size;
+
+    // Read or copied bytes (if not mapped)
+    std::vector<uint8_t> storage;
+
+    const uint8_t *bytes;
+    size_t size;
+
+    // Check the header and every offset
+    bool validate();
+
+public:
+    CookedLevel();
+    ~CookedLevel();
+
+    CookedLevel(const CookedLevel &) = delete;
+    CookedLevel &operator=(const CookedLevel &) = delete;
+
+    // Open a cooked level file
+    bool open(const char *path);
+
+    // Use cooked bytes already in memory (they're copied)
+    bool openMemory(const uint8_t *data, size_t data_size);
+
+    void close();
+
+    bool isOpen() const { return bytes != nullptr; }
+
+    const CookedLevelHeader &header() const { return *(const CookedLevelHeader *)bytes; }
+
+    const CookedTileset &tileset(uint32_t i) const { return ((const CookedTileset *)(bytes + header().tileset_offset))[i]; }
+    const CookedTileLayer &layer(uint32_t i) const { return ((const CookedTileLayer *)(bytes + header().layer_offset))[i]; }
+
+    // A layer's tile GIDs and flip flags (flags are nullptr if nothing in the layer is flipped)
+    const uint16_t *layerTiles(uint32_t i) const { return (const uint16_t *)(bytes + layer(i).tiles_offset); }
+    const uint8_t *layerFlags(uint32_t i) const { return layer(i).flags_offset ? bytes + layer(i).flags_offset : nullptr; }
+
+    // GridVal of every cell
+    const uint8_t *grid() const { return bytes + header().grid_offset; }
+
+    // Copy the static grid and spawn out into a Level
+    void toLevel(Level &level) const;
+};
+
+// Load just the static level from a cooked file
+bool loadCookedLevel(const char *path, Level &level);
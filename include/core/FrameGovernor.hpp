@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Tuning for FrameGovernor, times in seconds
+struct FrameGovernorOptions
+{
+    // Target frame time
+    double budget = 1.0 / 60.0;
+
+    // Percentile of recent frame times that's held to the budget (0.9: nine frames in ten)
+    double percentile = 0.9;
+
+    // How many frames the percentile is taken over
+    size_t window = 120;
+
+    // Step down when the percentile is over budget * step_down_ratio...
+    double step_down_ratio = 1.15;
+
+    // ...and only consider stepping up while it's under budget * step_up_ratio (the gap between the two
+    // is the hysteresis, a vsynced 60 Hz frame sits inside it)
+    double step_up_ratio = 1.05;
+
+    // Seconds under the step-up line before trying a higher tier, doubled (up to the max) every time a
+    // step up has to be taken back, so a tier that can't hold isn't retried every few seconds
+    double step_up_delay = 5.0;
+    double max_step_up_delay = 80.0;
+};
+
+// Picks a quality tier from how long frames are taking
+//
+// Tier 0 is the highest quality and tier_count - 1 the cheapest. Each frame's time is added to a rolling
+// window, and the tier steps down one at a time while the window's percentile runs over budget. Stepping
+// back up needs a sustained stretch of headroom. The window is cleared on every change, so each tier is
+// judged on its own frames.
+class FrameGovernor
+{
+private:
+    FrameGovernorOptions options;
+
+    int tier_count;
+    int tier;
+
+    // Ring buffer of recent frame times
+    std::vector<double> frame_times;
+    size_t head;
+    size_t count;
+
+    // Copy of the window the percentile is selected in (sized once, so frames don't allocate)
+    std::vector<double> scratch;
+
+    // Percentile of the window, as of the last full frame
+    double current_percentile;
+
+    // Time the percentile has been under the step-up line
+    double headroom_time;
+
+    // Current step-up delay (backs off after failed step ups)
+    double step_up_delay;
+
+    // The last change was a step up (so a step down straight after means it failed)
+    bool probing;
+
+    // Off: frames are still measured but the tier only changes with setTier
+    bool enabled;
+
+    // Forget the window after a change
+    void resetWindow();
+
+public:
+    FrameGovernor(int tier_count, int start_tier, FrameGovernorOptions options = {});
+
+    // Record a frame, returns true if the tier changed
+    bool addFrame(double frame_time);
+
+    int getTier() const;
+    int getTierCount() const;
+
+    // Force a tier (the governor carries on from there if it's enabled)
+    void setTier(int new_tier);
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    // Percentile of recent frame times (0 until the window has filled once)
+    double getPercentile() const;
+
+    const FrameGovernorOptions &getOptions() const;
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+
+#include "core/GridTypes.hpp"
+#include "core/GridBuffer.hpp"
+
+// Bit-packed copies of the static grid layers
+//
+// Each layer is stored twice: once per row (bit x of row y) and once per column (bit y of column x),
+// so both horizontal and vertical slides reduce to finding the nearest set bit with a count
+// leading/trailing zeros instruction. Rows and columns are padded to whole 64-bit words, which keeps
+// a 33 wide tower at one word per row and a 460 tall one at 8 words per column.
+class GridBitboards
+{
+public:
+    enum Layer : uint8_t
+    {
+        Layer_SolidBlock,
+        Layer_Damage,
+        Layer_CheckP,
+        Layer_Finish,
+
+        // Union of every layer (anything that stops a slide)
+        Layer_Blocking,
+
+        Layer_Count
+    };
+
+private:
+    int w;
+    int h;
+
+    // 64-bit words per row / column
+    int row_words;
+    int col_words;
+
+    std::vector<uint64_t> rows[Layer_Count];
+    std::vector<uint64_t> cols[Layer_Count];
+
+    // Layer a GridVal is stored in (Layer_Count if it isn't stored, eg. empty or the player)
+    static Layer layerOf(uint8_t val);
+
+    void setBit(Layer layer, int x, int y, bool on);
+
+    // Index of the first set bit after from, or len if there is none
+    static int findNext(const uint64_t *line, int len, int from);
+
+    // Index of the last set bit before from, or -1 if there is none
+    static int findPrev(const uint64_t *line, int from);
+
+public:
+    GridBitboards();
+
+    // Rebuild every layer from grid
+    void build(const GridBuffer<uint8_t> &grid);
+
+    // Update a single cell after it changed in the grid
+    void setCell(Vector2i pos, uint8_t val);
+
+    // GridVal stored at pos (GridVal_Empty if none of the layers have it)
+    GridVal cellAt(Vector2i pos) const;
+
+    // Row y / column x of a layer
+    const uint64_t *row(Layer layer, int y) const;
+    const uint64_t *column(Layer layer, int x) const;
+
+    // Bit-scan slide kernel, same result as stepping cell by cell until blocked
+    MoveInfo slide(Vector2i pos, Direction dir) const;
+};
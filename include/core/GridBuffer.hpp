@@ -0,0 +1,120 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+// Contiguous, row-major 2D grid
+// Cell (x, y) lives at index (y * width + x), so a whole row is one cache-friendly run of memory
+template <typename T>
+class GridBuffer
+{
+public:
+    // View over a single row (contiguous)
+    //--------------------------------------------------------------------------------------
+    class RowView
+    {
+    private:
+        T *ptr;
+        int len;
+
+    public:
+        RowView(T *ptr, int len) : ptr(ptr), len(len) {}
+
+        T &operator[](int x) const { return ptr[x]; }
+        int size() const { return len; }
+
+        T *begin() const { return ptr; }
+        T *end() const { return ptr + len; }
+    };
+
+    // View over a single column (strided by the grid width)
+    //--------------------------------------------------------------------------------------
+    class ColumnView
+    {
+    private:
+        T *ptr;
+        int len;
+        int stride;
+
+    public:
+        ColumnView(T *ptr, int len, int stride) : ptr(ptr), len(len), stride(stride) {}
+
+        T &operator[](int y) const { return ptr[(std::size_t)y * stride]; }
+        int size() const { return len; }
+    };
+
+    // Construction
+    //--------------------------------------------------------------------------------------
+    GridBuffer() : w(0), h(0) {}
+
+    GridBuffer(int width, int height, T fill_val = T{})
+        : w(width), h(height), cells((std::size_t)width * height, fill_val) {}
+
+    // Resize the grid, discarding its contents
+    void resize(int width, int height, T fill_val = T{})
+    {
+        w = width;
+        h = height;
+        cells.assign((std::size_t)width * height, fill_val);
+    }
+
+    // Set every cell to val
+    void fill(T val) { std::fill(cells.begin(), cells.end(), val); }
+
+    // Copy another grid's contents into this one, reusing this grid's allocation when the sizes match
+    void copyFrom(const GridBuffer &other)
+    {
+        w = other.w;
+        h = other.h;
+        cells.resize(other.cells.size());
+        std::copy(other.cells.begin(), other.cells.end(), cells.begin());
+    }
+
+    // Dimensions
+    //--------------------------------------------------------------------------------------
+    int width() const { return w; }
+    int height() const { return h; }
+    std::size_t size() const { return cells.size(); }
+
+    bool inBounds(int x, int y) const { return x >= 0 && x < w && y >= 0 && y < h; }
+
+    // Flat index of cell (x, y)
+    std::size_t index(int x, int y) const { return (std::size_t)y * w + x; }
+
+    // Access
+    //--------------------------------------------------------------------------------------
+
+    // Unchecked access
+    T &operator()(int x, int y) { return cells[index(x, y)]; }
+    const T &operator()(int x, int y) const { return cells[index(x, y)]; }
+
+    // Checked access, throws std::out_of_range if (x, y) is outside the grid
+    T &at(int x, int y)
+    {
+        if (!inBounds(x, y))
+            throw std::out_of_range("GridBuffer::at");
+        return cells[index(x, y)];
+    }
+
+    const T &at(int x, int y) const
+    {
+        if (!inBounds(x, y))
+            throw std::out_of_range("GridBuffer::at");
+        return cells[index(x, y)];
+    }
+
+    // Row and column views
+    RowView row(int y) { return RowView(cells.data() + index(0, y), w); }
+    ColumnView column(int x) { return ColumnView(cells.data() + x, h, w); }
+
+    // Raw storage
+    T *data() { return cells.data(); }
+    const T *data() const { return cells.data(); }
+
+private:
+    int w;
+    int h;
+    std::vector<T> cells;
+};
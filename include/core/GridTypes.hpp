@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+
+enum GridVal : uint8_t
+{
+    GridVal_Empty,
+    GridVal_Player,
+    GridVal_SolidBlock,
+    GridVal_Damage,
+    GridVal_CheckP,
+    GridVal_Finish
+};
+
+enum Direction : uint8_t
+{
+    Direction_Left,
+    Direction_Right,
+    Direction_Up,
+    Direction_Down,
+};
+
+struct Vector2i
+{
+    int x, y;
+};
+
+struct MoveInfo
+{
+    Vector2i final_pos;
+    GridVal blocked_by;
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+#include "core/Simulation.hpp"
+
+// A single key press, stamped with when it was seen (seconds, on whatever clock the caller uses)
+struct InputEvent
+{
+    SimInput input;
+    double time;
+};
+
+// Input-to-move latency statistics, in seconds
+struct LatencyStats
+{
+    double last;
+    double min;
+    double max;
+    double mean;
+    unsigned long count;
+};
+
+// Ordered buffer of input events waiting for the simulation
+//
+// Key presses are pushed as they arrive and the simulation pops one per slide, so taps that start
+// and end between two ticks, or several presses in one frame, are all applied in order. The buffer
+// holds at most depth events, and presses beyond that are dropped rather than overwriting older ones.
+class InputQueue
+{
+private:
+    // Ring buffer storage
+    std::vector<InputEvent> events;
+    size_t head;
+    size_t count;
+
+    // Presses dropped because the buffer was full
+    unsigned long dropped;
+
+    LatencyStats latency;
+
+public:
+    InputQueue(size_t depth = 4);
+
+    // Change how many events can be buffered (clears the queue)
+    void setDepth(size_t depth);
+    size_t getDepth() const;
+
+    // Queue an event, returns false (and drops it) if the buffer is full
+    bool push(SimInput input, double time);
+
+    // Take the oldest event, returns false if the queue is empty
+    bool pop(InputEvent &event);
+
+    // Throw away every queued event
+    void clear();
+
+    size_t size() const;
+    bool empty() const;
+    unsigned long getDropped() const;
+
+    // Latency
+    //--------------------------------------------------------------------------------------
+
+    // Record how long an event waited between being pressed and moving the player
+    void recordLatency(double seconds);
+    void resetLatency();
+    const LatencyStats &getLatency() const;
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "cute/cute_tiled.h"
+
+#include "core/GridTypes.hpp"
+#include "core/GridBuffer.hpp"
+
+// The static part of a level: what every cell holds before anything moves
+struct Level
+{
+    // Cell contents (never GridVal_Player, the player is placed by the simulation)
+    GridBuffer<uint8_t> grid;
+
+    // Cell the player spawns in ({-1, -1} if the level has no spawn)
+    Vector2i spawn_pos;
+
+    // Size of a cell in Tiled pixels
+    int tile_w;
+    int tile_h;
+};
+
+// Set up an empty level sized to a Tiled map
+void initLevel(const cute_tiled_map_t *map, Level &level);
+
+// Rasterize one Tiled object layer ("Collision", "Damage", "Checkpoints", "Finish" or "Objects") into the level
+// Returns true if the layer contained the player spawn
+bool stampObjectLayer(const cute_tiled_layer_t *layer, Level &level);
+
+// Load every object layer of a Tiled JSON map into level
+bool loadLevel(const char *path, Level &level);
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+
+#include "core/GridTypes.hpp"
+#include "core/SlideGraph.hpp"
+
+// A group of cells the player can get stuck in
+struct TrapRegion
+{
+    // Some cell in the region (for reporting)
+    Vector2i cell;
+
+    // Number of cells in the region
+    int size;
+};
+
+// What the slide graph says about a level's design
+struct LevelReport
+{
+    // Is there a spawn at all
+    bool has_spawn;
+
+    // Can the finish be reached from spawn
+    bool finish_reachable;
+
+    // Cells the player can reach from spawn
+    int reachable_cells;
+
+    // Strongly connected components among the reachable cells
+    int component_count;
+
+    // Reachable cells from which the finish can't be reached any more (only a reset gets the player out),
+    // grouped by strongly connected component
+    std::vector<TrapRegion> softlocks;
+    int softlock_cells;
+
+    // Checkpoints no reachable slide touches (a cell of each)
+    std::vector<Vector2i> unreachable_checkpoints;
+
+    // Reachable cells where every slide that moves the player ends in damage
+    std::vector<Vector2i> death_traps;
+
+    // Problems that make the level unbeatable or broken as designed
+    bool hasErrors() const { return !has_spawn || !finish_reachable || !unreachable_checkpoints.empty(); }
+
+    // Problems worth a look
+    bool hasWarnings() const { return !softlocks.empty() || !death_traps.empty(); }
+};
+
+// Analyze reachability, softlocks, checkpoints and forced deaths on a level's slide graph
+//
+// Edges that hit damage send the player back to a checkpoint (a state already visited) and edges that
+// touch the finish end the run, so neither is followed. Strongly connected components of what's left
+// are the regions the player can move freely within.
+LevelReport analyzeLevel(const SlideGraph &graph, Vector2i spawn);
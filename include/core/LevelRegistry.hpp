@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// A level in the campaign
+struct LevelEntry
+{
+    // File name without extension, e.g. "testmap2"
+    std::string name;
+
+    // Cooked level (name.ctl) and the Tiled JSON it's cooked from (name.json)
+    std::string cooked_path;
+    std::string json_path;
+};
+
+// The campaign's levels, in the order they're played
+//
+// Read from a text file with one level name per line (blank lines and lines starting with # are skipped).
+// The asset pipeline cooks the same list.
+class LevelRegistry
+{
+private:
+    std::vector<LevelEntry> levels;
+
+public:
+    // Read the level list, returns false if the file can't be read or lists no levels
+    bool load(const std::string &path);
+
+    // Add a level by name (dir is prepended to its paths)
+    void add(const std::string &name, const std::string &dir = "");
+
+    void clear();
+
+    size_t size() const;
+    bool empty() const;
+
+    const LevelEntry &at(size_t index) const;
+
+    // Index of the level called name, or -1
+    int find(const std::string &name) const;
+};
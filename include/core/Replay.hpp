@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "core/Level.hpp"
+#include "core/Simulation.hpp"
+
+// A single input in a recorded run
+struct ReplayInput
+{
+    // Simulation step the input was applied on (counted from the start of the run)
+    uint32_t tick;
+    SimInput input;
+};
+
+// A recorded run: the level it was played on and every input, tick-stamped
+//
+// Encoded as "CTRP", a version byte, the 64-bit level hash, then one varint per input holding
+// (ticks since the previous input << 3 | SimInput), ended by a varint with SimInput_None that holds the
+// ticks from the last input to the end of the run. A slide costs 1-3 bytes.
+struct Replay
+{
+    uint64_t level_hash;
+    std::vector<ReplayInput> inputs;
+
+    // Steps in the whole run
+    uint32_t end_tick;
+};
+
+// Hash of everything about a level that affects the rules (grid size, contents and spawn)
+uint64_t hashLevel(const Level &level);
+
+// Binary encoding
+//--------------------------------------------------------------------------------------
+
+void encodeReplay(const Replay &replay, std::vector<uint8_t> &out);
+
+// Returns false if data isn't a valid replay
+bool decodeReplay(const uint8_t *data, size_t size, Replay &replay);
+
+bool saveReplay(const std::string &path, const Replay &replay);
+bool loadReplay(const std::string &path, Replay &replay);
+
+// Recording
+//--------------------------------------------------------------------------------------
+
+// Builds a replay one simulation step at a time
+class ReplayRecorder
+{
+private:
+    Replay replay;
+    bool recording;
+
+public:
+    ReplayRecorder();
+
+    // Start a new run on a level
+    void begin(uint64_t level_hash);
+
+    // Call once per simulation step with that step's input
+    void record(SimInput input);
+
+    // Stop recording, the replay ends after the last step recorded
+    void end();
+
+    // Throw away the current run
+    void cancel();
+
+    bool isRecording() const;
+    const Replay &getReplay() const;
+};
+
+// Playback
+//--------------------------------------------------------------------------------------
+
+struct PlaybackResult
+{
+    // Replay was recorded on this level
+    bool level_matches;
+
+    // Run reached the finish
+    bool finished;
+
+    // Time ran out somewhere in the run, which resets the level (such a run doesn't count)
+    bool timed_out;
+
+    // Game time at the end of the run, in ticks (what the timer showed)
+    uint32_t time_ticks;
+
+    // Steps simulated
+    uint32_t steps;
+};
+
+// Feeds a replay's inputs to the simulation at the ticks they were recorded on
+class ReplayPlayer
+{
+private:
+    const Replay *replay;
+    size_t next_input;
+    uint32_t tick;
+
+public:
+    ReplayPlayer();
+
+    // Start playing back replay from its first tick (replay must outlive the player)
+    void start(const Replay &replay);
+
+    // Real-time playback: the input for the next step (call once per step)
+    SimInput nextInput();
+
+    // Has every step of the replay been played
+    bool isDone() const;
+};
+
+// Fast-forward: re-simulate a whole replay from the start of the level in one go
+//
+// sim must already be loaded with the level level_hash was taken from, it's reset before playing so one
+// simulation can check many replays. Idle steps between inputs are skipped in bulk with
+// Simulation::advance(), so a run costs one step per input rather than one per tick.
+PlaybackResult playReplay(Simulation &sim, uint64_t level_hash, const Replay &replay);
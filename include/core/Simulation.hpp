@@ -0,0 +1,170 @@
+#pragma once
+
+#include <vector>
+
+#include "core/GridTypes.hpp"
+#include "core/GridBuffer.hpp"
+#include "core/SlideTable.hpp"
+#include "core/Level.hpp"
+
+// One tick's worth of player input
+enum SimInput : uint8_t
+{
+    SimInput_None,
+    SimInput_Left,
+    SimInput_Right,
+    SimInput_Up,
+    SimInput_Down,
+
+    // Go back to the last checkpoint
+    SimInput_Reset,
+};
+
+// What happened during a tick (bit flags)
+enum SimEvent : uint8_t
+{
+    SimEvent_None = 0,
+    SimEvent_Moved = 1 << 0,
+    SimEvent_Died = 1 << 1,
+    SimEvent_Checkpoint = 1 << 2,
+    SimEvent_Finished = 1 << 3,
+    SimEvent_TimeUp = 1 << 4,
+    SimEvent_Reset = 1 << 5,
+};
+
+// A cell whose contents differ from the static level
+struct CellDelta
+{
+    Vector2i pos;
+
+    // What the level has there / what is there now
+    uint8_t static_val;
+    uint8_t val;
+};
+
+// Mutable game state saved at a checkpoint
+// Only what differs from the static level is recorded, so saving and restoring cost O(changes), not O(map)
+struct Checkpoint
+{
+    Vector2i player_pos;
+    Direction player_orient;
+
+    // Dynamic objects other than the player
+    std::vector<CellDelta> dynamic_cells;
+};
+
+// Headless, deterministic game rules
+//
+// Takes a level and is stepped one fixed tick at a time with that tick's input. Nothing here touches
+// graphics, audio or the wall clock, so the same level and input stream always give the same run.
+class Simulation
+{
+public:
+    // Simulation ticks per second of game time
+    static constexpr int tick_rate = 60;
+
+private:
+    // Grid-based Map
+    //--------------------------------------------------------------------------------------
+    Direction player_orient;
+
+    // The player's cell (authoritative, object_map is kept in sync with it)
+    Vector2i player_pos;
+
+    GridBuffer<uint8_t> object_map;
+
+    // Cells (other than the player's) that currently differ from the static level
+    std::vector<CellDelta> dynamic_cells;
+
+    // Last checkpoint reached, and the state at the start of the level
+    Checkpoint checkpoint;
+    Checkpoint level_start;
+
+    // Where a slide from any cell stops (holds a pointer to object_map)
+    SlideTable slide_table;
+
+    // Timing
+    //--------------------------------------------------------------------------------------
+    uint32_t ticks;
+    uint32_t time_limit_ticks;
+
+    // Has the player reached the finish
+    bool finished;
+
+    // Grid Handling
+    //--------------------------------------------------------------------------------------
+
+    // Moves an entity at pos by mov, then returns if the movement was successful (ie. not blocked)
+    bool gridMove(Vector2i pos, Vector2i mov);
+
+    // Save the current mutable state into cp
+    void saveCheckpoint(Checkpoint &cp);
+
+    // Return the mutable state to what was saved in cp
+    void restoreCheckpoint(const Checkpoint &cp);
+
+    // Apply one tick's input, returning what happened
+    uint8_t handleInput(SimInput input);
+
+public:
+    Simulation();
+
+    // Not copyable: slide_table points into this simulation's own object_map
+    Simulation(const Simulation &) = delete;
+    Simulation &operator=(const Simulation &) = delete;
+
+    // Start playing level (copies it, so level doesn't need to outlive the simulation)
+    // Returns false, leaving the simulation as it was, if the level's spawn isn't inside it
+    bool load(const Level &level);
+
+    // Back to the start of the level, with the timer at zero
+    void reset();
+
+    // Advance one tick, returning the SimEvent flags for it
+    uint8_t step(SimInput input);
+
+    // Advance count ticks with no input, exactly like count calls to step(SimInput_None) but in O(1)
+    // per time limit crossed, returning the combined SimEvent flags
+    uint8_t advance(uint32_t count);
+
+    // Level edits (hot reload)
+    //--------------------------------------------------------------------------------------
+
+    // Change what the static level has in a cell, keeping the player, timer and checkpoints
+    // (a dynamic object in the cell stays where it is, and returns to val on a reset)
+    void restampCell(Vector2i pos, GridVal val);
+
+    // Move the level's spawn (used on the next full reset)
+    void setSpawn(Vector2i pos);
+
+    // Move in a specified direction infinitely until blocked, returning the info of where it stopped and what it was blocked by
+    MoveInfo infGridMove(Vector2i pos, Direction dir);
+
+    // Check what type of entity is at the specified location
+    GridVal gridCheck(Vector2i pos) const;
+
+    // Debug builds: assert the grid holds exactly one player, in the tracked cell (scans the whole grid,
+    // so it's run on load, reset and checkpoint restore rather than every tick)
+    void checkInvariants() const;
+
+    // State
+    //--------------------------------------------------------------------------------------
+
+    // Returns which cell the player is in
+    Vector2i getPlayerPos() const;
+    Direction getPlayerOrient() const;
+
+    // How far up the level the player is (0 at the top, 1 at the bottom)
+    float getVertProgress() const;
+
+    const GridBuffer<uint8_t> &getObjectMap() const;
+    SlideTable &getSlideTable();
+
+    uint32_t getTicks() const;
+    float getTime() const;
+
+    void setTimeLimit(float seconds);
+    float getTimeLimit() const;
+
+    bool isFinished() const;
+};
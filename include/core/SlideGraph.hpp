@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+
+#include "core/GridTypes.hpp"
+#include "core/GridBuffer.hpp"
+#include "core/Level.hpp"
+
+// A level as a graph of slides
+//
+// Every cell is a node, with one edge per direction leading to where a slide from that cell stops
+// (the same result infGridMove gives in game) and what stopped it. Connected checkpoint cells are
+// grouped into numbered checkpoints, so analyses can tell which checkpoint a slide touched.
+class SlideGraph
+{
+public:
+    struct Edge
+    {
+        // Cell index the slide stops in
+        int32_t to;
+
+        // Checkpoint the slide touched (-1 if it wasn't stopped by one)
+        int32_t checkpoint;
+
+        // What stopped it (GridVal)
+        uint8_t blocked_by;
+    };
+
+private:
+    int w;
+    int h;
+
+    // Static cell contents
+    std::vector<uint8_t> cells;
+
+    // Four edges per cell, indexed by (cell * 4 + Direction)
+    std::vector<Edge> edges;
+
+    // Checkpoint number of each cell (-1 if not a checkpoint)
+    std::vector<int32_t> checkpoint_ids;
+    int checkpoint_count;
+
+    // Number the connected groups of checkpoint cells
+    void labelCheckpoints();
+
+public:
+    SlideGraph();
+
+    // Build the graph for a level's static grid
+    void build(const Level &level);
+
+    int width() const { return w; }
+    int height() const { return h; }
+    int cellCount() const { return w * h; }
+
+    // Convert between cell positions and node indices
+    int cellIndex(Vector2i pos) const { return pos.y * w + pos.x; }
+    Vector2i cellPos(int cell) const { return Vector2i{cell % w, cell / w}; }
+
+    // Can the player stand in a cell
+    bool isOpen(int cell) const { return cells[cell] == GridVal_Empty; }
+    GridVal cellVal(int cell) const { return (GridVal)cells[cell]; }
+
+    // The slide from a cell in a direction
+    const Edge &edge(int cell, Direction dir) const { return edges[(size_t)cell * 4 + dir]; }
+
+    // Which checkpoint a cell belongs to (-1 if none)
+    int checkpointId(int cell) const { return checkpoint_ids[cell]; }
+    int getCheckpointCount() const { return checkpoint_count; }
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "core/GridTypes.hpp"
+#include "core/GridBuffer.hpp"
+#include "core/GridBitboards.hpp"
+
+// Precomputed result of sliding from every cell in every direction
+//
+// Built once from the object map when the level loads, so a slide is a single lookup instead of a
+// cell-by-cell walk. GridVal_Player cells are treated as empty, since the player is the one sliding.
+// When a cell's contents change (eg. a dynamic object), call invalidateCell() and only the entries
+// in that cell's row and column are recomputed, lazily, the next time they are queried. Recomputing
+// an entry uses the bitboard slide kernel rather than walking the grid.
+class SlideTable
+{
+private:
+    struct Entry
+    {
+        // Coordinate along the direction of movement where the slide stops
+        uint16_t stop;
+
+        // What stopped it (GridVal)
+        uint8_t blocked_by;
+
+        // Needs recomputing before use
+        uint8_t dirty;
+    };
+
+    // Grid the table was built from
+    const GridBuffer<uint8_t> *grid;
+
+    // One table per Direction
+    GridBuffer<Entry> entries[4];
+
+    // Bit-packed layers, used to recompute stale entries
+    GridBitboards bitboards;
+
+    // Does a cell stop a slide
+    bool isBlocking(uint8_t val) const;
+
+    // Sweep a whole row or column, filling in entries for one direction
+    void buildRow(int y);
+    void buildColumn(int x);
+
+    // Recompute a single entry
+    Entry computeEntry(Vector2i pos, Direction dir) const;
+
+public:
+    SlideTable();
+
+    // Build the table for every cell of grid (grid must outlive the table)
+    void build(const GridBuffer<uint8_t> *grid);
+
+    // Where a slide from pos in dir stops, and what it was blocked by
+    MoveInfo query(Vector2i pos, Direction dir);
+
+    // Mark the entries whose slide could pass through pos as stale (call after the cell changed in the grid)
+    void invalidateCell(Vector2i pos);
+
+    // Bit-packed layers of the grid
+    const GridBitboards &getBitboards() const;
+};
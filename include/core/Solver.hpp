@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "core/GridTypes.hpp"
+#include "core/SlideGraph.hpp"
+#include "core/Simulation.hpp"
+
+struct SolverOptions
+{
+    // Require the route to touch every checkpoint before the finish
+    bool visit_all_checkpoints = false;
+
+    // Estimated time a good player takes per slide (reading the level, reacting, pressing), for par time
+    float seconds_per_move = 0.35f;
+};
+
+// The shortest route through a level
+struct Solution
+{
+    bool solved;
+
+    // Why there's no route (empty if solved)
+    std::string message;
+
+    // Inputs to play, one per slide, and the cell the player ends up in after each
+    std::vector<SimInput> inputs;
+    std::vector<Vector2i> path;
+
+    // Minimal number of slides (one per tick, so also the fewest ticks a run can take)
+    uint32_t moves;
+
+    // Estimated time for a human to play the route, in seconds
+    float par_time;
+
+    // Checkpoints the route touches
+    int checkpoints_visited;
+
+    // Search states expanded (for profiling)
+    size_t states_explored;
+};
+
+// Find the minimal number of slides from spawn to the finish
+//
+// Every slide costs one move, so this is a breadth-first search over the slide graph. Resetting or
+// dying only ever returns the player to a state they were already in, so those moves are never part
+// of a shortest route and the search ignores them.
+Solution solveLevel(const SlideGraph &graph, Vector2i spawn, const SolverOptions &options = SolverOptions());
@@ -19,6 +19,11 @@
 #include <random>
 #include <sstream>
 #include <queue>
+#include <cassert>
+#include <ctime>
+#include <cstring>
+#include <thread>
+#include <atomic>
 
 // Raylib Graphics
 #include "raylib.h"
@@ -30,9 +35,11 @@
 // Flecs (Fast Entity Component System)
 #include "flecs.h"
 
-// Emscripten
+// Emscripten (web builds only)
+#ifdef __EMSCRIPTEN__
 #include <emscripten.h>
 #include <emscripten/html5.h>
+#endif
 
 // 'Tiled'-generated Map loader (ensure map assets are in assets folder)
 #include "cute/cute_tiled.h"
@@ -45,6 +52,10 @@
 
 class Map;
 
+struct MapData;
+
+class MapLoader;
+
 class App;
 
 class Particle;
@@ -54,34 +65,22 @@ class ParticleSystem;
 // CUSTOM FILES HERE
 // ===================================================================
 
-enum GridVal : uint8_t
-{
-    GridVal_Empty,
-    GridVal_Player,
-    GridVal_SolidBlock,
-    GridVal_Damage,
-    GridVal_CheckP,
-    GridVal_Finish
-};
-
-enum Direction : uint8_t
-{
-    Direction_Left,
-    Direction_Right,
-    Direction_Up,
-    Direction_Down,
-};
-
-struct Vector2i
-{
-    int x, y;
-};
-
-struct MoveInfo
-{
-    Vector2i final_pos;
-    GridVal blocked_by;
-};
+// Headless game rules (grid, slides, level loading, simulation, solving and replays)
+#include "core/GridTypes.hpp"
+#include "core/GridBuffer.hpp"
+#include "core/GridBitboards.hpp"
+#include "core/SlideTable.hpp"
+#include "core/Level.hpp"
+#include "core/CookedLevel.hpp"
+#include "core/CookedAssets.hpp"
+#include "core/AtlasPacker.hpp"
+#include "core/Simulation.hpp"
+#include "core/InputQueue.hpp"
+#include "core/SlideGraph.hpp"
+#include "core/Solver.hpp"
+#include "core/Replay.hpp"
+#include "core/LevelRegistry.hpp"
+#include "core/FrameGovernor.hpp"
 
 // Raylib QOL extension  
 #include "raylib_extension.hpp"
@@ -89,6 +88,9 @@ struct MoveInfo
 // Custom Flecs components
 #include "components.hpp"
 
+// Background level loading
+#include "MapLoader.hpp"
+
 // Tiled map class
 #include "Map.hpp"
 
@@ -1,6 +1,12 @@
 #pragma once
 
-#include "main.hpp"
+// Only what the declarations need, so the types here are complete before main.hpp's headers use them
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "raylib.h"
 
 struct TextProps
 {
@@ -14,6 +20,10 @@ struct TextProps
 
 void SetGuiTextProps(TextProps props);
 
+// Drop shadows (turned off at low quality tiers, the shadowed draws below then skip their shadow pass)
+void SetShadowsEnabled(bool enabled);
+bool AreShadowsEnabled();
+
 void DrawGuiLabelShadow(Rectangle rect, std::string str, Vector2 offset, Color shadow_color);
 
 struct ShadowedTextureProps
@@ -28,4 +38,64 @@ struct ShadowedTextureProps
     Color shadow_color;
 };
 
-void DrawShadowedTexture(ShadowedTextureProps props);
\ No newline at end of file
+void DrawShadowedTexture(ShadowedTextureProps props);
+
+// Draw call counting
+//--------------------------------------------------------------------------------------
+
+// What the game drew this frame (raylib doesn't expose its batch counts, so draws are counted as they're made)
+struct DrawStats
+{
+    // Sprites, rectangles and text labels drawn
+    uint32_t draws;
+
+    // Batches raylib had to flush them in: a new batch starts whenever the texture changes, and after
+    // any shader, blend mode or render target change
+    uint32_t batches;
+};
+
+void ResetDrawStats();
+
+// Count a draw with texture_id (the helpers above count their own)
+void CountDraw(unsigned int texture_id);
+
+// Count a shader, blend mode or render target change, so the next draw starts a new batch
+void CountBatchBreak();
+
+const DrawStats &GetDrawStats();
+
+// Cooked assets (see core/CookedAssets.hpp)
+//--------------------------------------------------------------------------------------
+
+// Load a font like LoadFontEx(ttf_path, size, 0, glyph_count), using the cooked .ctf next to it if there is one
+Font LoadGameFont(const char *ttf_path, int size, int glyph_count);
+
+// Load a sound, using the cooked .qoa next to wav_path if there is one
+Sound LoadGameSound(const char *wav_path);
+
+// Sprite atlas (see core/CookedAssets.hpp)
+//--------------------------------------------------------------------------------------
+
+// Every sprite image in one texture
+struct SpriteAtlas
+{
+    Texture2D tex;
+
+    // Each sprite's rect in tex, by name (its image's file name without the extension)
+    std::map<std::string, Rectangle> rects;
+};
+
+// Load the cooked atlas at cooked_path, or pack image_paths into one if there's no cooked atlas
+// Shapes are drawn from the atlas' white sprite from then on, so they batch with sprites
+bool LoadSpriteAtlas(const char *cooked_path, const std::vector<std::string> &image_paths, SpriteAtlas &atlas);
+
+void UnloadSpriteAtlas(SpriteAtlas &atlas);
+
+// Name of the sprite an image is packed as
+std::string AtlasSpriteName(const std::string &image_path);
+
+// Look up a sprite's rect, returns false if it isn't in the atlas
+bool FindAtlasSprite(const SpriteAtlas &atlas, const std::string &name, Rectangle *rect);
+
+// Rect of part of a sprite (src is in the sprite's own pixels), {0, 0, 0, 0} if it isn't in the atlas
+Rectangle GetAtlasRect(const SpriteAtlas &atlas, const std::string &name, Rectangle src);
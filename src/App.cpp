@@ -1,28 +1,88 @@
 #include <App.hpp>
 
+// Every image drawn, packed into the sprite atlas (the asset pipeline cooks the same list into sprites.cta)
+static const std::vector<std::string> sprite_images = {"[v1.3] tranquil_tunnels_transparent.png", "cat.png", "spike_ours.png"};
+
+// Sprite names in the atlas
+static const std::string tileset_sprite = "[v1.3] tranquil_tunnels_transparent";
+static const std::string cat_sprite = "cat";
+
+// A rendering quality tier (see App::quality_governor)
+struct QualityTier
+{
+    const char *name;
+
+    // Background shader resolution
+    BackgroundQuality background;
+
+    // Drop shadows under text, sprites and the map
+    bool shadows;
+
+    // App target resolution, as a fraction of the screen
+    float render_scale;
+
+    // Particles spawned, as a fraction of the full count
+    float particle_density;
+};
+
+// Best first, each step down gives up the cheapest-looking thing next
+static const QualityTier quality_tiers[] = {
+    {"ultra", BackgroundQuality_Full, true, 1.f, 1.f},
+    {"high", BackgroundQuality_Half, true, 1.f, 1.f},
+    {"medium", BackgroundQuality_Quarter, true, 1.f, 0.5f},
+    {"low", BackgroundQuality_Eighth, false, 0.75f, 0.25f},
+    {"minimum", BackgroundQuality_Eighth, false, 0.5f, 0.f},
+};
+
+static const int quality_tier_count = sizeof(quality_tiers) / sizeof(quality_tiers[0]);
+
+// The half resolution background is indistinguishable once smoothed, so "high" is where the governor starts
+static const int default_quality_tier = 1;
+
 // App Initialization & Destruction
 // ==================================================
 
 // Constructor
 App::App(RenderTexture2D target, Vector2 screen_size)
+    : quality_governor(quality_tier_count, default_quality_tier)
 {
     // Set screen w and h
     this->target = target;
     this->screen_w = screen_size.x;
     this->screen_h = screen_size.y;
 
+    // main() makes the target at full resolution, the quality tier may shrink it
+    render_scale = 1.f;
+
     // Timing initialization
     //--------------------------------------------------------------------------------------
 
-    // Set gameplay timer
-    time_counter = 0;
-    time_limit = 560.0;
+    // Set gameplay time limit
+    sim.setTimeLimit(560.0);
 
     // Debug flag initialization
     //--------------------------------------------------------------------------------------
 
     render_colliders = false;
     render_positions = false;
+    render_debug_overlay = false;
+
+    // Input initialization
+    //--------------------------------------------------------------------------------------
+    input_queue.setDepth(input_buffer_depth);
+
+    // Fixed-timestep initialization
+    //--------------------------------------------------------------------------------------
+
+    last_frame = std::chrono::steady_clock::now();
+    sim_accumulator = 0.0;
+    render_alpha = 0.f;
+
+    rate_window_start = last_frame;
+    rate_window_ticks = 0;
+    rate_window_frames = 0;
+    measured_tick_rate = 0.f;
+    measured_frame_rate = 0.f;
 
     // Audio flag initialization
     //--------------------------------------------------------------------------------------
@@ -32,9 +92,10 @@ App::App(RenderTexture2D target, Vector2 screen_size)
     // Load fonts
     //--------------------------------------------------------------------------------------
 
-    lookout_font = LoadFontEx("fonts/Lookout 7.ttf", 128, 0, 250);
-    fear_font = LoadFontEx("fonts/Fear 11.ttf", 128, 0, 250);
-    absolute_font = LoadFontEx("fonts/Absolute 10.ttf", 128, 0, 250);
+    // Pre-baked by the asset pipeline when available
+    lookout_font = LoadGameFont("fonts/Lookout 7.ttf", 128, 250);
+    fear_font = LoadGameFont("fonts/Fear 11.ttf", 128, 250);
+    absolute_font = LoadGameFont("fonts/Absolute 10.ttf", 128, 250);
 
     // Initialize gamestate
     //--------------------------------------------------------------------------------------
@@ -48,28 +109,30 @@ App::App(RenderTexture2D target, Vector2 screen_size)
     ecs_world = std::make_unique<flecs::world>();
     initFlecsSystems();
 
-    // Initialize the Map
+    // Load the sprite atlas (before the map, which draws its tiles from it)
     //--------------------------------------------------------------------------------------
 
-    map = std::make_unique<Map>(ecs_world.get(), &object_map);
+    LoadSpriteAtlas("sprites.cta", sprite_images, sprite_atlas);
 
-    // Destination w and h stay the same
-    RenderTexture2D map_tex = map->getRenderTexture();
-    map_dest.width = map_tex.texture.width * 3.f;
-    map_dest.height = map_tex.texture.height * 3.f;
+    // Start loading the Map
+    //--------------------------------------------------------------------------------------
 
-    map_dest.x = screen_w / 2 - map_dest.width / 2;
-    map_dest.y = -map_dest.height;
+    // Campaign levels, in order
+    if (!level_registry.load("levels.txt"))
+    {
+        TraceLog(LOG_WARNING, "MAP: No level list, playing testmap2 only");
+        level_registry.add("testmap2");
+    }
+    level_index = 0;
 
-    player_vert_progress = 0.f;
+    // The menu is drawn while the first level loads in the background, see finishMapLoad()
+    map_loader = std::make_unique<MapLoader>(&sprite_atlas);
+    map_loader->start(level_registry.at(level_index).cooked_path, level_registry.at(level_index).json_path);
 
-    // Set first chekpoint and reset maps now
-    object_checkp_map = object_map;
-    object_reset_map = object_map;
+    map_dest = {screen_w / 2, 0, 0, 0};
+    prev_map_dest = map_dest;
 
-    player_orient = Direction_Down;
-    player_checkp_orient = player_orient;
-    player_reset_map_orient = player_orient;
+    player_vert_progress = 0.f;
 
     // Load game textures
     //--------------------------------------------------------------------------------------
@@ -78,7 +141,19 @@ App::App(RenderTexture2D target, Vector2 screen_size)
     // https://godotshaders.com/shader/balatro-paint-mix/
 
     bal_shader = LoadShader(0, "shaders/balatro.fs");
-    bal_texture = LoadRenderTexture(1280, 720);
+
+    Image bal_source_img = GenImageColor(1, 1, WHITE);
+    bal_source = LoadTextureFromImage(bal_source_img);
+    UnloadImage(bal_source_img);
+
+    // Sized by the quality tier
+    bal_texture = {};
+
+    // Rendering quality
+    //--------------------------------------------------------------------------------------
+
+    quality_tier = -1;
+    applyQualityTier(quality_governor.getTier());
 
     bal_shader_uni["spin_rotation"] = GetShaderLocation(bal_shader, "spin_rotation");
     bal_shader_uni["spin_speed"] = GetShaderLocation(bal_shader, "spin_speed");
@@ -109,10 +184,6 @@ App::App(RenderTexture2D target, Vector2 screen_size)
     SetShaderValue(bal_shader, bal_shader_uni["spin_amount"], &spin_amount, SHADER_UNIFORM_FLOAT);
     SetShaderValue(bal_shader, bal_shader_uni["pixel_filter"], &pix_filt, SHADER_UNIFORM_FLOAT);
     SetShaderValue(bal_shader, bal_shader_uni["delta_time"], &delta_t_bal, SHADER_UNIFORM_FLOAT);
-
-    // Load the default texture
-    loadTexFromImg("[v1.3] tranquil_tunnels_transparent.png", &ttt_tex);
-    loadTexFromImg("cat.png", &cat_tex);
 }
 
 // Destructor
@@ -120,6 +191,12 @@ App::~App()
 {
     // Shaders
     UnloadShader(bal_shader);
+    UnloadRenderTexture(bal_texture);
+    UnloadTexture(bal_source);
+
+    // Textures (the loading thread reads the atlas, so it's stopped first)
+    map_loader.reset();
+    UnloadSpriteAtlas(sprite_atlas);
 
     // Fonts
     UnloadFont(fear_font);
@@ -133,40 +210,36 @@ App::~App()
     }
 }
 
-// Load texture from an image
-void App::loadTexFromImg(std::string img_file, Texture2D *tex)
-{
-    Image img = LoadImage(img_file.c_str());
-    *tex = LoadTextureFromImage(img);
-    UnloadImage(img);
-}
-
 // Initialize all Flecs systems
 void App::initFlecsSystems()
 {
-    flecs::system player_system = ecs_world->system<plt::Player>()
-                                      .kind(flecs::PreUpdate)
-                                      .each([&](flecs::entity e, plt::Player &player)
-                                            {
-                                                PlayerSystem(e, player); //
-                                            });
-
+    // Simulation systems have no phase, they're run manually at a fixed rate from update()
+    player_system = ecs_world->system()
+                        .with<plt::Player>()
+                        .kind(0)
+                        .each([&](flecs::entity e)
+                              {
+                                  PlayerSystem(e); //
+                              });
+
+    map_pos_system = ecs_world->system()
+                         .kind(0)
+                         .run([&](flecs::iter &it)
+                              {
+                                  // Update where the map should be drawn
+                                  MapPosSystem(it.delta_time()); //
+                              });
+
+    // Render systems run every frame through ecs_world->progress()
     flecs::system map_system = ecs_world->system()
                                    .kind(flecs::PostUpdate)
                                    .run([&](flecs::iter &it)
                                         {
-                                            // Update the map
-                                            map->update(player_orient, cat_tex); //
+                                            // Stream in the map chunks coming into view
+                                            if (map)
+                                                map->update(getDrawMapDest(), Rectangle{0, 0, screen_w, screen_h}); //
                                         });
 
-    flecs::system map_pos_system = ecs_world->system()
-                                       .kind(flecs::PostUpdate)
-                                       .run([&](flecs::iter &it)
-                                            {
-                                                // Update where the map should be drawn
-                                                MapPosSystem(); //
-                                            });
-
     flecs::system render_system = ecs_world->system()
                                       .kind(flecs::PostUpdate)
                                       .run([&](flecs::iter &it)
@@ -175,20 +248,176 @@ void App::initFlecsSystems()
                                            });
 }
 
+// Upload the first level and start the simulation on it
+void App::finishMapLoad()
+{
+    std::unique_ptr<MapData> map_data = map_loader->take();
+    if (!map_data)
+        return;
+
+    useMap(std::make_unique<Map>(ecs_world.get(), *map_data, sprite_atlas), *map_data);
+
+    // Get the next level ready while this one is played
+    prefetchNextLevel();
+}
+
+// Make new_map the level being played (map_data is what it was loaded from)
+void App::useMap(std::unique_ptr<Map> new_map, const MapData &map_data)
+{
+    // The old level (if any) is freed here
+    map = std::move(new_map);
+
+    // Destination w and h stay the same
+    Vector2 map_size = map->getPixelSize();
+    map_dest.width = map_size.x * 3.f;
+    map_dest.height = map_size.y * 3.f;
+
+    map_dest.x = screen_w / 2 - map_dest.width / 2;
+    map_dest.y = -map_dest.height;
+    prev_map_dest = map_dest;
+
+    // Start the simulation on the map's level (the loader only hands over levels with a spawn)
+    if (!sim.load(map->getLevel()))
+        TraceLog(LOG_ERROR, "MAP: Level has no spawn");
+
+    // Solved and hashed by the loader
+    level_solution = map_data.solution;
+    level_hash = map_data.level_hash;
+
+#ifdef CATTOWER_HOT_RELOAD
+    watchLevelFile();
+#endif
+}
+
+// Start loading the level after the current one in the background (if there is one)
+void App::prefetchNextLevel()
+{
+    if (level_index + 1 >= level_registry.size())
+        return;
+
+    const LevelEntry &next = level_registry.at(level_index + 1);
+    map_loader->start(next.cooked_path, next.json_path);
+}
+
+// Swap in the prefetched next level and start playing it
+void App::advanceLevel()
+{
+    if (!next_map || !next_map_data)
+        return;
+
+    level_index++;
+
+    // Nothing left to load, the swap is just a pointer move
+    useMap(std::move(next_map), *next_map_data);
+    next_map_data.reset();
+
+    game_state = plt::GameState_Playing;
+    gameReset();
+
+    prefetchNextLevel();
+}
+
+#ifdef CATTOWER_HOT_RELOAD
+// Level hot reload
+// ======================================================================================
+
+// Start watching the current level's file
+void App::watchLevelFile()
+{
+    std::error_code ec;
+    level_file_time = std::filesystem::last_write_time(level_registry.at(level_index).json_path, ec);
+    level_watch_time = GetTime();
+}
+
+// Reload the level if its file has changed (checked every level_watch_interval)
+void App::pollLevelReload()
+{
+    if (!map || GetTime() - level_watch_time < level_watch_interval)
+        return;
+    level_watch_time = GetTime();
+
+    std::error_code ec;
+    std::filesystem::file_time_type file_time = std::filesystem::last_write_time(level_registry.at(level_index).json_path, ec);
+    if (ec || file_time == level_file_time)
+        return;
+
+    // Always take the new time, a half-written file will be written again (and fail to parse until then)
+    level_file_time = file_time;
+    reloadLevel();
+}
+
+// Apply the edited level in place
+void App::reloadLevel()
+{
+    const LevelEntry &entry = level_registry.at(level_index);
+    double start_time = GetTime();
+
+    // Cook the edited JSON in memory
+    std::vector<uint8_t> cooked_bytes;
+    std::string error;
+    CookedLevel cooked;
+    if (!cookLevelFile(entry.json_path.c_str(), cooked_bytes, error) || !cooked.openMemory(cooked_bytes.data(), cooked_bytes.size()))
+    {
+        TraceLog(LOG_WARNING, "RELOAD: Could not load %s (%s)", entry.json_path.c_str(), error.c_str());
+        return;
+    }
+
+    // Re-draw only the tiles that changed
+    int changed_tiles = map->reloadTiles(cooked);
+    if (changed_tiles < 0)
+    {
+        TraceLog(LOG_WARNING, "RELOAD: %s changed size, layers or tilesets, restart to load it", entry.json_path.c_str());
+        return;
+    }
+
+    // Re-stamp only the grid cells that changed (the player and timer are left alone)
+    Level new_level;
+    cooked.toLevel(new_level);
+
+    const Level &old_level = map->getLevel();
+    int changed_cells = 0;
+    for (int y = 0; y < new_level.grid.height(); y++)
+    {
+        for (int x = 0; x < new_level.grid.width(); x++)
+        {
+            if (old_level.grid(x, y) == new_level.grid(x, y))
+                continue;
+
+            sim.restampCell({x, y}, (GridVal)new_level.grid(x, y));
+            changed_cells++;
+        }
+    }
+
+    if (new_level.spawn_pos.x != old_level.spawn_pos.x || new_level.spawn_pos.y != old_level.spawn_pos.y)
+        sim.setSpawn(new_level.spawn_pos);
+
+    map->setLevel(new_level);
+
+    // The rules changed, so does the par time (runs recorded across the edit keep the old hash, and won't verify)
+    level_hash = hashLevel(new_level);
+
+    SlideGraph slide_graph;
+    slide_graph.build(new_level);
+    level_solution = solveLevel(slide_graph, new_level.spawn_pos, parSolverOptions());
+
+    TraceLog(LOG_INFO, "RELOAD: Reloaded %s in %.2fms (%d tiles, %d cells changed)",
+             entry.json_path.c_str(), (GetTime() - start_time) * 1000.0, changed_tiles, changed_cells);
+}
+#endif
+
 // Reset the game
 void App::gameReset()
 {
-    // Reset map and checkpoint
-    object_map = object_reset_map;
-    object_checkp_map = object_reset_map;
+    // Reset map, checkpoint and timer
+    sim.reset();
 
-    player_orient = player_reset_map_orient;
-    player_checkp_orient = player_reset_map_orient;
+    // Presses made before the reset shouldn't carry over into the new run
+    input_queue.clear();
 
-    particle_vec.clear();
+    // An unfinished run isn't worth keeping
+    replay_recorder.cancel();
 
-    // Reset timer
-    time_counter = 0.0;
+    particle_vec.clear();
 }
 
 // App update
@@ -196,23 +425,156 @@ void App::gameReset()
 
 void App::update()
 {
-    // Only progress world 60 times per sec (60 fps)
-    std::chrono::system_clock::time_point time_now = std::chrono::system_clock::now();
-    std::chrono::duration<double, std::milli> work_time = time_now - last_frame;
+    // Real time since the last frame (steady_clock never jumps, unlike system_clock)
+    std::chrono::steady_clock::time_point time_now = std::chrono::steady_clock::now();
+    double frame_time = std::chrono::duration<double>(time_now - last_frame).count();
+    last_frame = time_now;
+
+    sim_accumulator += std::min(frame_time, max_frame_time);
 
-    if (work_time.count() >= 16.67)
+    // Finish loading the first level once the loader is done with it, after that it prefetches the next level
+    if (map_loader->poll())
     {
-        // Update last frame time to now
-        last_frame = std::chrono::system_clock::now();
+        if (!map)
+            finishMapLoad();
+        else if (!next_map_data && !(next_map_data = map_loader->take()))
+            TraceLog(LOG_WARNING, "MAP: Could not prefetch %s", level_registry.at(level_index + 1).name.c_str());
+    }
+
+#ifdef CATTOWER_HOT_RELOAD
+    // Pick up edits to the level from Tiled
+    pollLevelReload();
+#endif
+
+    // Upload the next level during the win screen, where a few milliseconds on the main thread go unnoticed
+    if (game_state == plt::GameState_Win && next_map_data && !next_map)
+        next_map = std::make_unique<Map>(ecs_world.get(), *next_map_data, sprite_atlas);
 
-        // Progress FLECS world
-        ecs_world->progress();
+    // Queue key presses before ticking, so every press this frame is seen by the simulation
+    pollInput();
+
+    // Run as many fixed simulation ticks as real time has accumulated
+    const double tick_dt = 1.0 / Simulation::tick_rate;
+    while (sim_accumulator >= tick_dt)
+    {
+        prev_map_dest = map_dest;
+
+        player_system.run((float)tick_dt);
+        map_pos_system.run((float)tick_dt);
+
+        sim_accumulator -= tick_dt;
+        rate_window_ticks++;
+    }
+
+    // Where this frame falls between the last tick and the next one
+    render_alpha = (float)(sim_accumulator / tick_dt);
+
+    // Toggle the debug overlay
+    if (IsKeyPressed(KEY_F1))
+        render_debug_overlay = !render_debug_overlay;
+
+    // Switch between drawing the map from chunks and with the tilemap shader
+    if (IsKeyPressed(KEY_F2) && map)
+    {
+        MapRenderMode mode = map->getRenderMode() == MapRenderMode_Chunks ? MapRenderMode_Shader : MapRenderMode_Chunks;
+        if (!map->setRenderMode(mode))
+            TraceLog(LOG_WARNING, "MAP: This map can't be drawn with the tilemap shader");
+    }
+
+    // Cycle the rendering quality: auto, then each tier fixed from best to cheapest
+    if (IsKeyPressed(KEY_F3))
+    {
+        if (quality_governor.isEnabled())
+        {
+            quality_governor.setEnabled(false);
+            quality_governor.setTier(0);
+        }
+        else if (quality_governor.getTier() + 1 < quality_governor.getTierCount())
+            quality_governor.setTier(quality_governor.getTier() + 1);
+        else
+            quality_governor.setEnabled(true);
+    }
+
+    // Step quality down when frames run over budget, and back up when there's room
+    quality_governor.addFrame(std::min(frame_time, max_frame_time));
+    if (quality_governor.getTier() != quality_tier)
+        applyQualityTier(quality_governor.getTier());
+
+    // Render every display frame
+    ecs_world->progress((float)frame_time);
+    rate_window_frames++;
+
+    // Report tick and frame rates once a second
+    double window_time = std::chrono::duration<double>(time_now - rate_window_start).count();
+    if (window_time >= 1.0)
+    {
+        measured_tick_rate = (float)(rate_window_ticks / window_time);
+        measured_frame_rate = (float)(rate_window_frames / window_time);
+
+        rate_window_start = time_now;
+        rate_window_ticks = 0;
+        rate_window_frames = 0;
     }
 
     // Handle game music as often as possible to avoid audio clipping
     handleGameMusic();
 }
 
+// Write the finished run to replays/ (native builds only)
+void App::saveRunReplay()
+{
+#ifndef __EMSCRIPTEN__
+    std::error_code ec;
+    std::filesystem::create_directories("replays", ec);
+
+    std::stringstream path_stream;
+    path_stream << "replays/run_" << (long long)std::time(nullptr) << "_" << sim.getTicks() << ".ctr";
+
+    if (saveReplay(path_stream.str(), replay_recorder.getReplay()))
+        TraceLog(LOG_INFO, "REPLAY: Saved %s", path_stream.str().c_str());
+    else
+        TraceLog(LOG_WARNING, "REPLAY: Could not save %s", path_stream.str().c_str());
+#endif
+}
+
+// Queue this frame's key presses (stamped with GetTime())
+void App::pollInput()
+{
+    // raylib keeps every key pressed since the last frame, in order, so quick taps aren't lost
+    int key;
+    while ((key = GetKeyPressed()) != 0)
+    {
+        // Only presses made while playing should move the player
+        if (game_state != plt::GameState_Playing)
+            continue;
+
+        SimInput input = SimInput_None;
+        switch (key)
+        {
+        case KEY_W:
+            input = SimInput_Up;
+            break;
+        case KEY_S:
+            input = SimInput_Down;
+            break;
+        case KEY_A:
+            input = SimInput_Left;
+            break;
+        case KEY_D:
+            input = SimInput_Right;
+            break;
+        case KEY_R:
+            input = SimInput_Reset;
+            break;
+        default:
+            break;
+        }
+
+        if (input != SimInput_None)
+            input_queue.push(input, GetTime());
+    }
+}
+
 // Game Audio
 // ======================================================================================
 
@@ -224,13 +586,13 @@ void App::handleGameMusic()
         InitAudioDevice();
         is_audio_initialized = true;
 
-        jump_sound = LoadSound("Jump 1.wav");
+        jump_sound = LoadGameSound("Jump 1.wav");
         SetSoundVolume(jump_sound, 0.4);
 
-        cat_sound = LoadSound("Cat 1.wav");
+        cat_sound = LoadGameSound("Cat 1.wav");
         SetSoundVolume(cat_sound, 0.4);
 
-        game_over_sound = LoadSound("Game Over II ~ v1.wav");
+        game_over_sound = LoadGameSound("Game Over II ~ v1.wav");
         SetSoundVolume(game_over_sound, 0.4);
 
         // Add the music in order with plt::GameMusic enum
@@ -302,228 +664,83 @@ void App::playGameMusic(Music &mus)
     }
 }
 
-// Grid Handling
-// ======================================================================================
-
-// Moves an entity at pos by mov, then returns if the movement was successful (ie. not blocked)
-bool App::gridMove(Vector2i pos, Vector2i mov)
-{
-    // Return false if value is out of range
-    if (pos.x + mov.x < 0 || pos.x + mov.x >= object_map.size() || pos.y + mov.y < 0 || pos.y + mov.y >= object_map.back().size())
-    {
-        return false;
-    }
-    // Move from current position to destination if destination is empty, and return true
-    else if (object_map[pos.x + mov.x][pos.y + mov.y] == GridVal_Empty)
-    {
-        object_map[pos.x + mov.x][pos.y + mov.y] = object_map[pos.x][pos.y];
-        object_map[pos.x][pos.y] = GridVal_Empty;
-        return true;
-    }
-    // If destination is occupied, return false
-    else
-    {
-        return false;
-    }
-}
-
-// Move in a specified direction infinitely until blocked, returning the info of where it stopped and what it was blocked by
-MoveInfo App::infGridMove(Vector2i pos, Direction dir)
-{
-    // Determine which direction to move in
-    Vector2i mov = {0, 0};
-    switch (dir)
-    {
-    case Direction_Up:
-        mov = {0, -1};
-        break;
-    case Direction_Down:
-        mov = {0, 1};
-        break;
-    case Direction_Left:
-        mov = {-1, 0};
-        break;
-    case Direction_Right:
-        mov = {1, 0};
-        break;
-    default:
-        break;
-    }
-
-    // Move infinitely until blocked
-    while (gridMove(pos, mov))
-    {
-        pos.x += mov.x;
-        pos.y += mov.y;
-    }
-
-    // Return the final position of the moving block and what it hit
-    return MoveInfo{{pos.x, pos.y}, (GridVal)gridCheck({pos.x + mov.x, pos.y + mov.y})};
-}
-
-// Check what type of entity is at the specified location
-GridVal App::gridCheck(Vector2i pos)
-{
-    // Return GridVal_SolidBlock if the position is out of range
-    if (pos.x < 0 || pos.x >= object_map.size() || pos.y < 0 || pos.y >= object_map.back().size())
-    {
-        return GridVal_SolidBlock;
-    }
-    return (GridVal)object_map[pos.x][pos.y];
-}
-
-// Returns which cell the player is in
-Vector2i App::getPlayerPos()
-{
-    for (int i = 0; i < object_map.size(); i++)
-        for (int j = 0; j < object_map[i].size(); j++)
-            if (object_map[i][j] == GridVal_Player)
-                return {i, j};
-
-    return {-1, -1};
-}
-
 // FLECS Systems
 // ======================================================================================
 
 // Handle the player
-void App::PlayerSystem(flecs::entity e, plt::Player &player)
+void App::PlayerSystem(flecs::entity e)
 {
-    // Get player's position on the grid once player wants to move
-    Vector2i pos = getPlayerPos();
-
     // Calculate current player progress
-    player_vert_progress = (float)pos.y / (float)object_map.back().size();
+    player_vert_progress = sim.getVertProgress();
 
     // Don't try to move if not currently playing the game
     if (game_state != plt::GameState_Playing)
         return;
 
+    // Player Input (one queued press per tick, and a slide always finishes within its tick)
+    InputEvent input_event = {SimInput_None, 0.0};
+    input_queue.pop(input_event);
+
+    // Record from the first tick of a run
+    if (!replay_recorder.isRecording())
+        replay_recorder.begin(level_hash);
+
+    // Advance the simulation by one tick
+    uint8_t events = sim.step(input_event.input);
+    replay_recorder.record(input_event.input);
+
+    // How long the press waited before being applied
+    if (input_event.input != SimInput_None)
+        input_queue.recordLatency(GetTime() - input_event.time);
+
     // If the time runs out
-    if (time_counter >= time_limit)
+    if (events & SimEvent_TimeUp)
     {
         PlaySound(game_over_sound);
         gameReset();
         game_state = plt::GameState_Lose;
-    }
-
-    // Player Input
-    if (player.move_state == plt::PlayerMvnmtState_Idle)
-    {
-        if (IsKeyDown(KEY_W))
-            player.move_state = plt::PlayerMvnmtState_Up;
-        if (IsKeyDown(KEY_S))
-            player.move_state = plt::PlayerMvnmtState_Down;
-        if (IsKeyDown(KEY_A))
-            player.move_state = plt::PlayerMvnmtState_Left;
-        if (IsKeyDown(KEY_D))
-            player.move_state = plt::PlayerMvnmtState_Right;
-        if (IsKeyDown(KEY_R))
-        {
-            object_map = object_checkp_map;
-            player_orient = player_checkp_orient;
-            return;
-        }
-    }
-
-    // If the player isn't moving, we're done
-    if (player.move_state == plt::PlayerMvnmtState_Idle)
         return;
-
-    // Set the desired movement vector
-    Direction desired_dir;
-    switch (player.move_state)
-    {
-    case plt::PlayerMvnmtState_Up:
-        desired_dir = Direction_Up;
-        player_orient = Direction_Up;
-        break;
-    case plt::PlayerMvnmtState_Down:
-        desired_dir = Direction_Down;
-        player_orient = Direction_Down;
-        break;
-    case plt::PlayerMvnmtState_Left:
-        desired_dir = Direction_Left;
-        player_orient = Direction_Right;
-        break;
-    case plt::PlayerMvnmtState_Right:
-        desired_dir = Direction_Right;
-        player_orient = Direction_Left;
-        break;
-    default:
-        break;
     }
 
-    // Move
-    MoveInfo mov_info;
-    mov_info = infGridMove({pos.x, pos.y}, desired_dir);
-
-    // After moving, player is back to idle
-    player.move_state = plt::PlayerMvnmtState_Idle;
-
-    // Handle what you were hit by
-    switch (mov_info.blocked_by)
+    // Hit a damage block
+    if (events & SimEvent_Died)
     {
-        // Hit a damage block
-    case GridVal_Damage:
-    {
-        // Create blood
-        // createParticlesInCell({mov_info.final_pos.x, mov_info.final_pos.y}, 0.3, RED, 250.5);
-        object_map = object_checkp_map;
-        player_orient = player_checkp_orient;
-
-        // Play jumping sound
+        // Play cat sound
         if (is_audio_initialized)
             PlaySound(cat_sound);
-
         return;
     }
-    break;
-
-        // Hit a checkpoint
-    case GridVal_CheckP:
-    {
-        object_checkp_map = object_map;
-        player_checkp_orient = player_orient;
-    }
-    break;
 
-        // Hit the finish
-    case GridVal_Finish:
+    // Hit the finish
+    if (events & SimEvent_Finished)
     {
         game_state = plt::GameState_Win;
-    }
-    break;
 
-    default:
-        break;
+        replay_recorder.end();
+        saveRunReplay();
     }
 
-    // Return if we didn't actually move anywhere
-    if (pos.x == mov_info.final_pos.x && pos.y == mov_info.final_pos.y)
-        return;
-
-    // Play jumping sound
-    if (is_audio_initialized)
+    // Play jumping sound if we actually moved anywhere
+    if ((events & SimEvent_Moved) && is_audio_initialized)
         PlaySound(jump_sound);
 
-    // Set new position
-    pos.x = mov_info.final_pos.x;
-    pos.y = mov_info.final_pos.y;
-
     // Recalculate player progress after move
-    player_vert_progress = (float)pos.y / (float)object_map.back().size();
+    player_vert_progress = sim.getVertProgress();
 }
 
 // Handle the map's position on the screen
-void App::MapPosSystem()
+void App::MapPosSystem(float delta_time)
 {
+    // Nothing to move until the level has loaded
+    if (!map)
+        return;
+
     Vector2 ideal_map_pos = {0, 0};
-    RenderTexture2D map_tex = map->getRenderTexture();
+    Vector2 map_size = map->getPixelSize();
 
     // Destination w and h stay the same
-    map_dest.width = map_tex.texture.width * 2.5f;
-    map_dest.height = map_tex.texture.height * 2.5f;
+    map_dest.width = map_size.x * 2.5f;
+    map_dest.height = map_size.y * 2.5f;
 
     // It will always be ideal to have the map horizontally centered on the screen
     ideal_map_pos.x = screen_w / 2 - map_dest.width / 2;
@@ -556,48 +773,68 @@ void App::MapPosSystem()
 
     float dist_to_ideal = abs(Vector2Distance({map_dest.x, map_dest.y}, ideal_map_pos));
 
-    float des_x = (ideal_map_pos.x - map_dest.x) * 0.01 * dist_to_ideal * ecs_world->delta_time();
-    float des_y = (ideal_map_pos.y - map_dest.y) * 0.01 * dist_to_ideal * ecs_world->delta_time();
+    float des_x = (ideal_map_pos.x - map_dest.x) * 0.01 * dist_to_ideal * delta_time;
+    float des_y = (ideal_map_pos.y - map_dest.y) * 0.01 * dist_to_ideal * delta_time;
 
     map_dest.x += std::abs(des_x) > 100.f ? 100.f * std::copysignf(1.0, des_x) : des_x;
     map_dest.y += std::abs(des_y) > 100.f ? 100.f * std::copysignf(1.0, des_y) : des_y;
 }
 
+// The map moves once per tick, so draw it between where it was and where it is now
+Rectangle App::getDrawMapDest()
+{
+    return Rectangle{Lerp(prev_map_dest.x, map_dest.x, render_alpha),
+                     Lerp(prev_map_dest.y, map_dest.y, render_alpha),
+                     map_dest.width,
+                     map_dest.height};
+}
+
 // Render system (onto render texture)
 void App::RenderSystem()
 {
     // Pre-draw
     // -------------------------------------------------------------------------------------
 
-    // Calculate map render texture destination
+    // Count this frame's draws from here
+    ResetDrawStats();
+
+    // Background shader, into its own (smaller) target
+    renderBackground();
+
+    // Calculate map destination
     // --------------------------------------------------------------------------------------
-    RenderTexture2D map_tex = map->getRenderTexture();
-    Rectangle map_src = {0, 0, (float)map_tex.texture.width, (float)-map_tex.texture.height};
+    Rectangle draw_map_dest = getDrawMapDest();
 
-    // Begin rendering to the application texture
+    // Begin rendering to the application texture (scaled to its resolution)
     BeginTextureMode(target);
     ClearBackground(RAYWHITE);
+    BeginMode2D(getRenderCamera());
 
-    // Balatro Shader
-    delta_t_bal += ecs_world->delta_time();
-    SetShaderValue(bal_shader, bal_shader_uni["delta_time"], &delta_t_bal, SHADER_UNIFORM_FLOAT);
-    BeginShaderMode(bal_shader);
-    DrawTexture(bal_texture.texture, 0, 0, ColorAlpha(WHITE, 0.1));
-    EndShaderMode();
+    // Balatro Shader (upscaled, render textures are upside down)
+    // Drawn opaque: the shader ignores the vertex colour, so it has always covered the background fully
+    DrawTexturePro(bal_texture.texture,
+                   Rectangle{0, 0, (float)bal_texture.texture.width, -(float)bal_texture.texture.height},
+                   Rectangle{0, 0, screen_w, screen_h},
+                   Vector2{0, 0}, 0.0f, WHITE);
+    CountDraw(bal_texture.texture.id);
 
     // Draw map shadow and map
     // --------------------------------------------------------------------------------------
 
-    // Draw map shadow
-    DrawRectangleRec(Rectangle{map_dest.x + 5, map_dest.y + 5, map_dest.width, map_dest.height}, BLACK);
+    if (map)
+    {
+        // Draw map shadow (just the part on screen, the map is far taller than the screen)
+        Rectangle map_shadow = {draw_map_dest.x + 5, draw_map_dest.y + 5, draw_map_dest.width, draw_map_dest.height};
+        if (AreShadowsEnabled())
+        {
+            DrawRectangleRec(GetCollisionRec(map_shadow, Rectangle{0, 0, screen_w, screen_h}), BLACK);
+            CountDraw(GetShapesTexture().id);
+        }
 
-    // Draw map
-    DrawTexturePro(map_tex.texture,
-                   map_src,
-                   map_dest,
-                   Vector2{0, 0},
-                   0.0,
-                   WHITE);
+        // Draw map (only the chunks on screen) and the player
+        map->draw(draw_map_dest, Rectangle{0, 0, screen_w, screen_h}, sim.getPlayerOrient(),
+                  sprite_atlas.tex, GetAtlasRect(sprite_atlas, cat_sprite, Rectangle{0, 0, 8, 8}), sim.getPlayerPos());
+    }
 
     // Draw GUI
     // --------------------------------------------------------------------------------------
@@ -620,8 +857,8 @@ void App::RenderSystem()
         DrawGuiLabelShadow(Rectangle{(screen_w * 0.23f * 0.f), 350, screen_w * 0.3f, 50}, "slide", {5, 5}, BLACK);
 
         ShadowedTextureProps cat_props;
-        cat_props.tex = cat_tex;
-        cat_props.src = Rectangle{0, 0, 8, 8};
+        cat_props.tex = sprite_atlas.tex;
+        cat_props.src = GetAtlasRect(sprite_atlas, cat_sprite, Rectangle{0, 0, 8, 8});
         cat_props.dest = Rectangle{(screen_w * 0.23f * 0.f) + 125,
                                    420,
                                    screen_w * 0.1f,
@@ -638,8 +875,8 @@ void App::RenderSystem()
         DrawGuiLabelShadow(Rectangle{(screen_w * 0.23f * 1.f), 310, screen_w * 0.3f, 50}, "Avoid Spikes", {5, 5}, BLACK);
 
         ShadowedTextureProps spikes_props;
-        spikes_props.tex = ttt_tex;
-        spikes_props.src = Rectangle{1000, 688, 8, 8};
+        spikes_props.tex = sprite_atlas.tex;
+        spikes_props.src = GetAtlasRect(sprite_atlas, tileset_sprite, Rectangle{1000, 688, 8, 8});
         spikes_props.dest = Rectangle{(screen_w * 0.23f * 1.f) + 100,
                                       350,
                                       screen_w * 0.15f,
@@ -657,8 +894,8 @@ void App::RenderSystem()
         DrawGuiLabelShadow(Rectangle{(screen_w * 0.23f * 2.f), 350, screen_w * 0.3f, 50}, "save progress", {5, 5}, BLACK);
 
         ShadowedTextureProps checkpoint_props;
-        checkpoint_props.tex = ttt_tex;
-        checkpoint_props.src = Rectangle{760, 16, 8, 8};
+        checkpoint_props.tex = sprite_atlas.tex;
+        checkpoint_props.src = GetAtlasRect(sprite_atlas, tileset_sprite, Rectangle{760, 16, 8, 8});
         checkpoint_props.dest = Rectangle{(screen_w * 0.23f * 2.f) + 125,
                                           420,
                                           screen_w * 0.1f,
@@ -676,27 +913,46 @@ void App::RenderSystem()
         DrawGuiLabelShadow(Rectangle{(screen_w * 0.23f * 3.f), 350, screen_w * 0.3f, 50}, "TIME", {5, 5}, BLACK);
 
         std::stringstream speedrun_limit_stream;
-        speedrun_limit_stream << std::fixed << std::setprecision(2) << time_limit;
+        speedrun_limit_stream << std::fixed << std::setprecision(2) << sim.getTimeLimit();
         SetGuiTextProps({absolute_font, WHITE, TEXT_ALIGN_CENTER, TEXT_ALIGN_MIDDLE, 100, 17});
         DrawGuiLabelShadow(Rectangle{(screen_w * 0.23f * 3.f), 460, screen_w * 0.3f, 50}, speedrun_limit_stream.str() + "s", {5, 5}, BLACK);
 
         // Play Button
         SetGuiTextProps({absolute_font, Color{0x2B, 0x26, 0x27, 0xFF}, TEXT_ALIGN_CENTER, TEXT_ALIGN_MIDDLE, lookout_font.baseSize / 3, 30});
-        if (GuiButton(Rectangle{screen_w * 0.23f, 580, screen_w - (screen_w * 0.5f), 100}, "PLAY"))
-            game_state = plt::GameState_Playing;
+        Rectangle play_rect = {screen_w * 0.23f, 580, screen_w - (screen_w * 0.5f), 100};
+        if (map)
+        {
+            if (GuiButton(play_rect, "PLAY"))
+                game_state = plt::GameState_Playing;
+        }
+        // Loading bar in place of the button until the level is ready
+        else
+        {
+            float progress = map_loader->getProgress();
+
+            DrawRectangleRec(Rectangle{play_rect.x + 5, play_rect.y + 5, play_rect.width, play_rect.height}, BLACK);
+            DrawRectangleRec(play_rect, Color{0x2B, 0x26, 0x27, 0xFF});
+            DrawRectangleRec(Rectangle{play_rect.x, play_rect.y, play_rect.width * progress, play_rect.height}, PURPLE);
+
+            std::stringstream loading_stream;
+            loading_stream << (map_loader->hasFailed() ? "LOAD FAILED" : "LOADING ");
+            if (!map_loader->hasFailed())
+                loading_stream << (int)(progress * 100.f) << "%";
+
+            SetGuiTextProps({absolute_font, WHITE, TEXT_ALIGN_CENTER, TEXT_ALIGN_MIDDLE, lookout_font.baseSize / 3, 30});
+            DrawGuiLabelShadow(play_rect, loading_stream.str(), {5, 5}, BLACK);
+        }
     }
     break;
     case plt::GameState_Playing:
     {
-        // Speedrun time counter
+        // Speedrun time counter (counted in simulation ticks)
         // --------------------------------------------------------------------------------------
-        time_counter += ecs_world->delta_time();
-
         std::stringstream speedrun_stream;
-        speedrun_stream << std::fixed << std::setprecision(2) << time_counter;
+        speedrun_stream << std::fixed << std::setprecision(2) << sim.getTime();
 
         std::stringstream speedrun_limit_stream;
-        speedrun_limit_stream << std::fixed << std::setprecision(2) << time_limit;
+        speedrun_limit_stream << std::fixed << std::setprecision(2) << sim.getTimeLimit();
 
         // Time
         SetGuiTextProps({absolute_font, WHITE, TEXT_ALIGN_CENTER, TEXT_ALIGN_MIDDLE, 50, 17});
@@ -730,11 +986,21 @@ void App::RenderSystem()
 
         // Win Time
         std::stringstream speedrun_stream;
-        speedrun_stream << std::fixed << std::setprecision(2) << time_counter;
+        speedrun_stream << std::fixed << std::setprecision(2) << sim.getTime();
 
         SetGuiTextProps({absolute_font, RED, TEXT_ALIGN_CENTER, TEXT_ALIGN_MIDDLE, 100, 17});
         DrawGuiLabelShadow({40, 120, screen_w - 80, 200}, (speedrun_stream.str() + "s").c_str(), {5, 5}, BLACK);
 
+        // Par time and the fewest slides the level can be finished in
+        if (level_solution.solved)
+        {
+            std::stringstream par_stream;
+            par_stream << "PAR " << std::fixed << std::setprecision(2) << level_solution.par_time << "s  (" << level_solution.moves << " slides)";
+
+            SetGuiTextProps({absolute_font, YELLOW, TEXT_ALIGN_CENTER, TEXT_ALIGN_MIDDLE, 40, 17});
+            DrawGuiLabelShadow({40, 270, screen_w - 80, 60}, par_stream.str().c_str(), {5, 5}, BLACK);
+        }
+
         // Restart Button
         SetGuiTextProps({absolute_font, Color{0x2B, 0x26, 0x27, 0xFF}, TEXT_ALIGN_CENTER, TEXT_ALIGN_MIDDLE, lookout_font.baseSize / 3, 30});
 
@@ -744,6 +1010,19 @@ void App::RenderSystem()
             gameReset();
         }
 
+        // Next Tower Button (the next level was prefetched while this one was played)
+        Rectangle next_rect = {screen_w * 0.23f, 520, screen_w - (screen_w * 0.5f), 100};
+        if (next_map)
+        {
+            if (GuiButton(next_rect, "NEXT TOWER"))
+                advanceLevel();
+        }
+        else if (map_loader->isLoading())
+        {
+            SetGuiTextProps({absolute_font, WHITE, TEXT_ALIGN_CENTER, TEXT_ALIGN_MIDDLE, lookout_font.baseSize / 3, 30});
+            DrawGuiLabelShadow(next_rect, "LOADING NEXT TOWER", {5, 5}, BLACK);
+        }
+
         // Menu Button
         SetGuiTextProps({absolute_font, Color{0x2B, 0x26, 0x27, 0xFF}, TEXT_ALIGN_CENTER, TEXT_ALIGN_MIDDLE, lookout_font.baseSize / 3, 30});
         if (GuiButton(Rectangle{100, 100, 120, 80}, "Menu"))
@@ -804,11 +1083,179 @@ void App::RenderSystem()
     camera.projection = CAMERA_PERSPECTIVE;           // Camera projection type
 
     {
+        // 3D mode replaces the 2D camera, so it's picked back up after
+        EndMode2D();
         BeginMode3D(camera);
         DrawCubeV({-2.5, -2.5, -2.5}, {5.f, 5.f, 5.f}, RED);
         DrawCubeWiresV({-2.5, -2.5, -2.5}, {5.f, 5.f, 5.f}, MAROON);
         EndMode3D();
+        BeginMode2D(getRenderCamera());
     }
 
+    if (render_debug_overlay)
+        drawDebugOverlay();
+
+    EndMode2D();
     EndTextureMode();
+}
+
+// Background
+// ======================================================================================
+
+// Fraction of the screen's resolution each background tier renders at
+static float BackgroundScale(BackgroundQuality quality)
+{
+    switch (quality)
+    {
+    case BackgroundQuality_Half:
+        return 0.5f;
+    case BackgroundQuality_Quarter:
+        return 0.25f;
+    case BackgroundQuality_Eighth:
+        return 0.125f;
+    default:
+        return 1.f;
+    }
+}
+
+// Re-create bal_texture for a quality tier
+void App::setBackgroundQuality(BackgroundQuality quality)
+{
+    bal_quality = quality;
+
+    if (bal_texture.id != 0)
+        UnloadRenderTexture(bal_texture);
+
+    float scale = BackgroundScale(quality);
+    bal_texture = LoadRenderTexture(std::max(1, (int)(screen_w * scale)), std::max(1, (int)(screen_h * scale)));
+
+    // Smooth when upscaled, so the lower tiers blur rather than turn blocky
+    SetTextureFilter(bal_texture.texture, TEXTURE_FILTER_BILINEAR);
+
+    TraceLog(LOG_INFO, "BACKGROUND: Rendering at %dx%d", bal_texture.texture.width, bal_texture.texture.height);
+}
+
+// Render the background shader into bal_texture (before the app target is bound)
+void App::renderBackground()
+{
+    delta_t_bal += ecs_world->delta_time();
+    SetShaderValue(bal_shader, bal_shader_uni["delta_time"], &delta_t_bal, SHADER_UNIFORM_FLOAT);
+
+    BeginTextureMode(bal_texture);
+    BeginShaderMode(bal_shader);
+    CountBatchBreak();
+
+    DrawTexturePro(bal_source, Rectangle{0, 0, 1, 1},
+                   Rectangle{0, 0, (float)bal_texture.texture.width, (float)bal_texture.texture.height},
+                   Vector2{0, 0}, 0.0f, WHITE);
+    CountDraw(bal_source.id);
+
+    EndShaderMode();
+    EndTextureMode();
+    CountBatchBreak();
+}
+
+// Rendering quality
+// ======================================================================================
+
+// Apply a quality tier's background, shadow, render target and particle settings
+void App::applyQualityTier(int tier)
+{
+    const QualityTier &settings = quality_tiers[tier];
+
+    if (quality_tier < 0 || settings.background != bal_quality)
+        setBackgroundQuality(settings.background);
+
+    if (settings.render_scale != render_scale)
+        setRenderScale(settings.render_scale);
+
+    SetShadowsEnabled(settings.shadows);
+    ParticleSystem::setDensity(settings.particle_density);
+
+    quality_tier = tier;
+
+    TraceLog(LOG_INFO, "QUALITY: %s (background 1/%d, %s shadows, %.0f%% resolution, %.0f%% particles)",
+             settings.name, 1 << settings.background, settings.shadows ? "with" : "no",
+             settings.render_scale * 100.f, settings.particle_density * 100.f);
+}
+
+// Re-create target at a fraction of screen_w x screen_h
+void App::setRenderScale(float scale)
+{
+    render_scale = scale;
+
+    UnloadRenderTexture(target);
+    target = LoadRenderTexture(std::max(1, (int)(screen_w * scale)), std::max(1, (int)(screen_h * scale)));
+
+    // Pixels don't line up with the window below full resolution, so blend them instead of doubling some
+    if (scale < 1.f)
+        SetTextureFilter(target.texture, TEXTURE_FILTER_BILINEAR);
+}
+
+// Camera that scales screen coordinates to the target
+Camera2D App::getRenderCamera()
+{
+    Camera2D camera = {0};
+    camera.zoom = render_scale;
+    return camera;
+}
+
+// The target the app renders into (re-created when the render scale changes)
+RenderTexture2D App::getTarget()
+{
+    return target;
+}
+
+// Draw the debug overlay on top of everything else
+void App::drawDebugOverlay()
+{
+    std::stringstream overlay_stream;
+    overlay_stream << std::fixed << std::setprecision(1)
+                   << "tick " << measured_tick_rate << "/s (target " << Simulation::tick_rate << ")\n"
+                   << "render " << measured_frame_rate << "/s\n";
+
+    // Draw calls this frame (everything drawn before the overlay)
+    const DrawStats &draw_stats = GetDrawStats();
+    overlay_stream << "batches " << draw_stats.batches << " (" << draw_stats.draws << " draws)\n";
+
+    // Rendering quality tier, and what it's set
+    overlay_stream << "quality " << quality_tiers[quality_tier].name << (quality_governor.isEnabled() ? " (auto), p" : " (fixed), p")
+                   << (int)(quality_governor.getOptions().percentile * 100.0) << " " << std::setprecision(1)
+                   << quality_governor.getPercentile() * 1000.0 << "ms\n"
+                   << "bg " << bal_texture.texture.width << "x" << bal_texture.texture.height
+                   << ", target " << target.texture.width << "x" << target.texture.height
+                   << (AreShadowsEnabled() ? ", shadows\n" : ", no shadows\n");
+
+    // Input-to-move latency
+    const LatencyStats &latency = input_queue.getLatency();
+    overlay_stream << std::setprecision(2)
+                   << "input " << latency.last * 1000.0 << "ms (avg " << latency.mean * 1000.0
+                   << ", max " << latency.max * 1000.0 << ")\n"
+                   << "queued " << input_queue.size() << "/" << input_queue.getDepth()
+                   << ", dropped " << input_queue.getDropped() << "\n";
+
+    if (map)
+    {
+        // Map load time (upload is the only part on the main thread)
+        const MapLoadStats &map_load = map->getLoadStats();
+        overlay_stream << "map load " << map_load.total_ms << "ms (upload " << map_load.upload_ms << "ms)\n";
+
+        // Map chunk streaming
+        const MapChunkStats &chunks = map->getChunkStats();
+        overlay_stream << "chunks " << chunks.drawn << " drawn, " << chunks.resident << "/" << chunks.capacity
+                       << " resident, " << chunks.rasterized << " rasterized\n";
+
+        // Map drawing work this frame
+        const MapFrameStats &map_frame = map->getFrameStats();
+        overlay_stream << (map->getRenderMode() == MapRenderMode_Shader ? "shader" : "chunks") << " map "
+                       << map_frame.draw_calls << " draws, " << std::setprecision(0)
+                       << map_frame.pixels / 1000.0 << "k px, " << map_frame.rasterized << " rasterized";
+    }
+    else
+    {
+        overlay_stream << "map loading " << std::setprecision(0) << map_loader->getProgress() * 100.f << "%";
+    }
+
+    DrawRectangle(screen_w - 430, 10, 420, 265, ColorAlpha(BLACK, 0.7f));
+    DrawText(overlay_stream.str().c_str(), screen_w - 420, 20, 20, GREEN);
 }
\ No newline at end of file
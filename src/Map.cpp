@@ -1,345 +1,733 @@
 #include "Map.hpp"
 
-// Constructor
-Map::Map(flecs::world *ecs_world, std::vector<std::vector<uint8_t>> *object_map)
+// Constructor (uploads data prepared by MapLoader, the tileset images are taken)
+Map::Map(flecs::world *ecs_world, MapData &data, const SpriteAtlas &atlas)
 {
-    this->object_map = object_map;
     this->ecs_world = ecs_world;
 
-    // Parse Map
-    map = cute_tiled_load_map_from_file("testmap2.json", NULL);
+    double start_time = GetTime();
 
-    loadTilesets();
+    loadTilesets(data, atlas);
 
-    loadMapDimensions();
+    loadMapDimensions(data.cooked);
 
-    // Initialize map rendertarget
-    map_target = LoadRenderTexture(map_w * tile_w, map_h * tile_h);
+    parseMapLayers(data);
 
-    // Initialize object_map size
-    *object_map = std::vector<std::vector<uint8_t>>(map_w,
-                                                    std::vector<uint8_t>(map_h));
+    // Chunks are the default, the shader is there to switch to
+    render_mode = MapRenderMode_Chunks;
+    loadTilemapShader();
 
-    parseMapLayers();
+    // Everything but the upload was done by the loader
+    load_stats.level_ms = data.level_ms;
+    load_stats.tilesets_ms = data.tilesets_ms;
+    load_stats.solve_ms = data.solve_ms;
+    load_stats.upload_ms = (GetTime() - start_time) * 1000.0;
+    load_stats.total_ms = load_stats.level_ms + load_stats.tilesets_ms + load_stats.solve_ms + load_stats.upload_ms;
+
+    TraceLog(LOG_INFO, "MAP: Loaded in %.2fms (level %.2fms, tilesets %.2fms, solve %.2fms, upload %.2fms)",
+             load_stats.total_ms, load_stats.level_ms, load_stats.tilesets_ms, load_stats.solve_ms, load_stats.upload_ms);
 }
 
 // Map destructor
 Map::~Map()
 {
-    UnloadRenderTexture(map_target);
-
     for (auto &ts_info : tilesets_info)
-        UnloadTexture(ts_info.tex);
+    {
+        if (!ts_info.in_atlas)
+            UnloadTexture(ts_info.tex);
+    }
 
-    for (auto &tl_info : tilelayers_info)
-        UnloadRenderTexture(tl_info.tex);
+    unloadChunks();
 
-    cute_tiled_free_map(map);
+    UnloadTexture(index_tex);
+    UnloadShader(tilemap_shader);
 }
 
 // Load Tileset Textures
-void Map::loadTilesets()
+void Map::loadTilesets(MapData &data, const SpriteAtlas &atlas)
 {
-    cute_tiled_tileset_t *ts_ptr = map->tilesets;
-    while (ts_ptr)
+    for (uint32_t i = 0; i < data.cooked.header().tileset_count; i++)
     {
-        // Get the tileset image's path
-        std::filesystem::path ts_path(ts_ptr->image.ptr);
-
-        // Load tileset's image
-        Image ts_img = LoadImage(ts_path.filename().string().c_str());
         TilesetInfo ts_info;
-        ts_info.info = *ts_ptr;
+        ts_info.info = data.cooked.tileset(i);
+
+        // Draw from the sprite atlas if the tileset is packed in it, so tiles batch with every other sprite
+        Rectangle atlas_rect;
+        ts_info.in_atlas = FindAtlasSprite(atlas, AtlasSpriteName(ts_info.info.image), &atlas_rect);
 
-        // Load texture
-        ts_info.tex = LoadTextureFromImage(ts_img);
-        UnloadImage(ts_img);
+        if (ts_info.in_atlas)
+        {
+            ts_info.tex = atlas.tex;
+            ts_info.origin = {atlas_rect.x, atlas_rect.y};
+        }
+        // Otherwise upload the tileset's image (already decoded by the loader)
+        else
+        {
+            ts_info.tex = LoadTextureFromImage(data.tileset_images[i]);
+            ts_info.origin = {0, 0};
+        }
 
         // Add to tilesets
         tilesets_info.push_back(ts_info);
+    }
 
-        // Go onto next tileset
-        ts_ptr = ts_ptr->next;
+    // The pixels are on the GPU now
+    for (Image &img : data.tileset_images)
+        UnloadImage(img);
+    data.tileset_images.clear();
+
+    // Size the lookup table to the highest GID of any tileset (GID 0 is the empty tile)
+    int32_t gid_count = 1;
+    for (const TilesetInfo &ts_info : tilesets_info)
+        gid_count = std::max(gid_count, ts_info.info.firstgid + ts_info.info.tilecount);
+
+    tile_lookup.assign(gid_count, TileLookup{-1, {0, 0, 0, 0}});
+
+    // Fill in every tile of every tileset, so drawing a tile is a single indexed load
+    for (int32_t i = 0; i < (int32_t)tilesets_info.size(); i++)
+    {
+        const CookedTileset &tileset = tilesets_info[i].info;
+        const Vector2 &origin = tilesets_info[i].origin;
+        if (tileset.columns <= 0)
+            continue;
+
+        for (int32_t tile = 0; tile < tileset.tilecount; tile++)
+        {
+            TileLookup &entry = tile_lookup[tileset.firstgid + tile];
+            entry.tileset = i;
+            entry.src = {origin.x + (float)(tileset.margin + (tile % tileset.columns) * (tileset.tile_w + tileset.spacing)),
+                         origin.y + (float)(tileset.margin + (tile / tileset.columns) * (tileset.tile_h + tileset.spacing)),
+                         (float)tileset.tile_w,
+                         (float)tileset.tile_h};
+        }
     }
 }
 
 // Load map dimensions
-void Map::loadMapDimensions()
+void Map::loadMapDimensions(const CookedLevel &cooked)
 {
-    map_w = map->width;
-    map_h = map->height;
+    map_w = cooked.header().width;
+    map_h = cooked.header().height;
+
+    tile_w = cooked.header().tile_w;
+    tile_h = cooked.header().tile_h;
+
+    // Nothing is rasterized until it's first drawn
+    chunks_x = (map_w + chunk_tiles - 1) / chunk_tiles;
+    chunks_y = (map_h + chunk_tiles - 1) / chunk_tiles;
 
-    tile_w = map->tilewidth;
-    tile_h = map->tileheight;
+    chunk_texture = {};
+    chunk_pool.clear();
+    chunk_slots.assign(chunks_x * chunks_y, -1);
+
+    frame_count = 0;
+    frame_stats = {};
+    chunk_stats = {};
+    chunk_stats.capacity = max_resident_chunks;
 }
 
 // Parse through all map layers
-void Map::parseMapLayers()
+void Map::parseMapLayers(const MapData &data)
 {
-    // Render map layers to RenderTexture
-    cute_tiled_layer_t *layer = map->layers;
+    // Tile layers are drawn from the cooked data chunk by chunk, as they come into view
+    for (uint32_t i = 0; i < data.cooked.header().layer_count; i++)
+        parseTileLayer(data.cooked, i);
 
-    while (layer)
-    {
-        if (std::string("tilelayer") == layer->type.ptr)
-            parseTileLayer(layer);
-        else if (std::string("objectgroup") == layer->type.ptr)
-            parseObjLayer(layer);
-        else
-            printf("Unknown layer type %s", layer->type.ptr);
-
-        layer = layer->next;
-    }
+    // The object layers were rasterized into the grid when the level was cooked
+    parseObjLayers(data.level);
 }
 
 // Parse a single tile layer
-void Map::parseTileLayer(cute_tiled_layer_t *layer)
+void Map::parseTileLayer(const CookedLevel &cooked, uint32_t layer_index)
 {
-    int *data = layer->data;
-    int data_count = layer->data_count;
+    const uint16_t *tiles = cooked.layerTiles(layer_index);
+    const uint8_t *flags = cooked.layerFlags(layer_index);
 
-    // Create the RenderTexture2D for this layer
     TileLayerInfo layer_info;
-    layer_info.tex = LoadRenderTexture(map_w * tile_w, map_h * tile_h);
-    layer_info.opacity = layer->opacity;
+    layer_info.tiles.assign(tiles, tiles + map_w * map_h);
 
-    for (int column = 0; column < map_w; column++)
-    {
-        for (int row = 0; row < map_h; row++)
-        {
-            // Get the tile num for the tile on this layer
-            int tile_data = data[map_w * row + column];
+    // Layers with nothing flipped have no flags in the cooked level
+    if (flags)
+        layer_info.flags.assign(flags, flags + map_w * map_h);
+    else
+        layer_info.flags.assign(map_w * map_h, 0);
 
-            // Rotation flags
-            const int FlippedHorizontallyFlag = 0x8000'0000;
-            const int FlippedVerticallyFlag = 0x4000'0000;
-            const int FlippedAntiDiagonallyFlag = 0x2000'0000;
+    layer_info.opacity = cooked.layer(layer_index).opacity;
 
-            // Get the flags
-            int tile_flags = tile_data & 0xF000'0000;
+    // Add layer info to tilelayers_info vector
+    tilelayers_info.push_back(layer_info);
+}
 
-            // Get the tile data without the flags
-            tile_data = tile_data & 0x0FFF'FFFF;
+// Load the static grid (collision, damage, checkpoints, finish) and add the player at spawn
+void Map::parseObjLayers(const Level &loaded_level)
+{
+    // Colliders, damage, checkpoints and finish were rasterized into the cooked grid, and copied out by the loader
+    level = loaded_level;
 
-            // We're done if the tile is empty
-            if (tile_data == 0)
-                continue;
+    // Add the player at spawn
+    if (level.spawn_pos.x >= 0)
+    {
+        flecs::entity player_e = ecs_world->entity("Player");
+        player_e.add<plt::Player>();
+    }
+}
 
-            // Determine the tile's tileset
-            TilesetInfo *this_tile_info;
-            for (auto &tile_info : tilesets_info)
-            {
-                if (tile_info.info.firstgid <= tile_data && tile_data <= tile_info.info.firstgid + tile_info.info.tilecount - 1)
-                {
-                    this_tile_info = &tile_info;
-                    break;
-                }
-            }
+// Chunk streaming
+// ======================================================================================
 
-            // Determine src and destination Rectangles
-            Rectangle src_rect = {(float)tile_w * ((tile_data - this_tile_info->info.firstgid) % this_tile_info->info.columns),
-                                  (float)tile_h * ((tile_data - this_tile_info->info.firstgid) / this_tile_info->info.columns),
-                                  (float)tile_w,
-                                  (float)tile_h};
+// Range of chunks (inclusive) that land inside view when the map is drawn at dest
+void Map::visibleChunks(Rectangle dest, Rectangle view, int &first_x, int &first_y, int &last_x, int &last_y)
+{
+    // Size of a chunk once scaled to dest
+    float chunk_dest_w = dest.width * chunk_tiles / map_w;
+    float chunk_dest_h = dest.height * chunk_tiles / map_h;
+
+    first_x = std::max(0, (int)std::floor((view.x - dest.x) / chunk_dest_w));
+    first_y = std::max(0, (int)std::floor((view.y - dest.y) / chunk_dest_h));
+    last_x = std::min(chunks_x - 1, (int)std::floor((view.x + view.width - dest.x) / chunk_dest_w));
+    last_y = std::min(chunks_y - 1, (int)std::floor((view.y + view.height - dest.y) / chunk_dest_h));
+}
 
-            if (FlippedHorizontallyFlag & tile_flags)
-                src_rect.width *= -1;
+// Stream in the chunks needed to draw the map at dest (in target space) with view visible
+void Map::update(Rectangle dest, Rectangle view)
+{
+    frame_count++;
+    frame_stats = {};
 
-            if (FlippedVerticallyFlag & tile_flags)
-                src_rect.height *= -1;
+    // The shader draws straight from the index texture, there's nothing to stream
+    if (render_mode == MapRenderMode_Shader)
+        return;
 
-            float tile_rotation = 0.0;
-            if (FlippedAntiDiagonallyFlag & tile_flags)
-            {
-                tile_rotation = 90.f;
-            }
+    if (dest.width <= 0 || dest.height <= 0)
+        return;
 
-            Rectangle dest_rect = {(float)column * tile_w + tile_w / 2.f,
-                                   (float)row * tile_h + tile_h / 2.f,
-                                   (float)tile_w,
-                                   (float)tile_h};
+    // One chunk row of margin above and below, so scrolling doesn't wait on a rasterize
+    float margin = dest.height * chunk_tiles / map_h;
+    view.y -= margin;
+    view.height += margin * 2;
 
-            // Draw to the rendertexture
-            BeginTextureMode(layer_info.tex);
-            DrawTexturePro(this_tile_info->tex, src_rect, dest_rect, {tile_w / 2.f, tile_h / 2.f}, tile_rotation, WHITE);
-            EndTextureMode();
-        }
-    }
+    int first_x, first_y, last_x, last_y;
+    visibleChunks(dest, view, first_x, first_y, last_x, last_y);
 
-    // Add layer info to tilelayers_info vector
-    tilelayers_info.push_back(layer_info);
+    for (int chunk_y = first_y; chunk_y <= last_y; chunk_y++)
+        for (int chunk_x = first_x; chunk_x <= last_x; chunk_x++)
+            requestChunk(chunk_x, chunk_y);
 }
 
-// Parse a single object layer
-void Map::parseObjLayer(cute_tiled_layer_t *layer)
+// Make a chunk resident, rasterizing it into the least recently used slot if it isn't
+void Map::requestChunk(int chunk_x, int chunk_y)
 {
-    // Add Solid Bodies
-    // --------------------------------------------------------------------------------------
-    if (std::string("Collision") == layer->name.ptr)
+    int32_t chunk_index = chunk_y * chunks_x + chunk_x;
+
+    // Already resident, only redrawn if its tiles have changed
+    int32_t slot = chunk_slots[chunk_index];
+    if (slot >= 0)
     {
-        cute_tiled_object_t *layer_obj = layer->objects;
+        MapChunk &chunk = chunk_pool[slot];
+        chunk.last_used = frame_count;
 
-        // Iterate over each collider object
-        while (layer_obj)
-        {
-            // Set all of the grid spaces within the collider to GridVal_SolidBlock
-            for (float temp_w = 0; temp_w < layer_obj->width; temp_w += tile_w)
-                for (float temp_h = 0; temp_h < layer_obj->height; temp_h += tile_h)
-                    (*object_map)[int((layer_obj->x + temp_w) / 8)][int((layer_obj->y + temp_h) / 8)] = GridVal_SolidBlock;
+        if (chunk.dirty)
+            rasterizeChunk(chunk, chunk_x, chunk_y);
 
-            layer_obj = layer_obj->next;
-        }
+        return;
     }
 
-    // Add objects
-    // --------------------------------------------------------------------------------------
-    else if (std::string("Objects") == layer->name.ptr)
+    // Every slot shares one texture
+    if (chunk_texture.id == 0)
+        chunk_texture = LoadRenderTexture(chunk_pool_columns * chunk_tiles * tile_w, chunk_pool_columns * chunk_tiles * tile_h);
+
+    // Use a new slot while the pool has room
+    if (chunk_pool.size() < max_resident_chunks)
     {
-        cute_tiled_object_t *layer_obj = layer->objects;
+        int slot_index = (int)chunk_pool.size();
+
+        MapChunk chunk;
+        chunk.slot = {(float)(slot_index % chunk_pool_columns * chunk_tiles * tile_w),
+                      (float)(slot_index / chunk_pool_columns * chunk_tiles * tile_h),
+                      (float)(chunk_tiles * tile_w),
+                      (float)(chunk_tiles * tile_h)};
+        chunk.chunk_index = -1;
+        chunk.last_used = 0;
+        chunk.dirty = false;
+
+        slot = (int32_t)chunk_pool.size();
+        chunk_pool.push_back(chunk);
+    }
+    // Otherwise take the least recently used one
+    else
+    {
+        slot = 0;
+        for (int32_t i = 1; i < (int32_t)chunk_pool.size(); i++)
+        {
+            if (chunk_pool[i].last_used < chunk_pool[slot].last_used)
+                slot = i;
+        }
+
+        // Everything in the pool is needed this frame, the chunk will have to wait
+        if (chunk_pool[slot].last_used == frame_count)
+            return;
+
+        chunk_slots[chunk_pool[slot].chunk_index] = -1;
+        chunk_stats.evicted++;
+    }
+
+    MapChunk &chunk = chunk_pool[slot];
+    chunk.chunk_index = chunk_index;
+    chunk.last_used = frame_count;
+    chunk_slots[chunk_index] = slot;
+
+    rasterizeChunk(chunk, chunk_x, chunk_y);
+}
+
+// Draw every tile layer of a chunk into its slot
+void Map::rasterizeChunk(MapChunk &chunk, int chunk_x, int chunk_y)
+{
+    int first_column = chunk_x * chunk_tiles;
+    int first_row = chunk_y * chunk_tiles;
+    int last_column = std::min(first_column + chunk_tiles, map_w);
+    int last_row = std::min(first_row + chunk_tiles, map_h);
+
+    // Draw the whole chunk in one render pass, raylib batches the tiles into as few draw calls as it can
+    // (it only has to flush when the tileset texture or blend mode changes)
+    BeginTextureMode(chunk_texture);
+    CountBatchBreak();
+
+    // Clear just this chunk's slot (shapes come from the sprite atlas, so this batches with the tiles)
+    DrawRectangleRec(chunk.slot, GRAY);
+    CountDraw(GetShapesTexture().id);
 
-        while (layer_obj)
+    frame_stats.draw_calls++;
+    frame_stats.pixels += (uint64_t)(chunk.slot.width * chunk.slot.height);
+
+    // Layers are composited in order, each tile faded by its layer's opacity
+    for (const TileLayerInfo &layer : tilelayers_info)
+    {
+        for (int row = first_row; row < last_row; row++)
         {
-            // Add the player at spawn
-            // ==================================================
-            if (std::string("Spawn") == layer_obj->name.ptr)
+            for (int column = first_column; column < last_column; column++)
             {
-                (*object_map)[int(layer_obj->x / 8)][int(layer_obj->y / 8)] = GridVal_Player;
+                // Get the tile num for the tile on this layer
+                int tile_data = layer.tiles[map_w * row + column];
 
-                flecs::entity player_e = ecs_world->entity("Player");
-                player_e.set<plt::Player>({plt::PlayerMvnmtState_Idle});
-            }
+                // Get the flags
+                uint8_t tile_flags = layer.flags[map_w * row + column];
+
+                // We're done if the tile is empty
+                if (tile_data == 0)
+                    continue;
+
+                // Look up the tile's tileset and src rect (GIDs no tileset has are skipped)
+                if (tile_data >= (int)tile_lookup.size() || tile_lookup[tile_data].tileset < 0)
+                    continue;
+
+                const TileLookup &lookup = tile_lookup[tile_data];
+                TilesetInfo *this_tile_info = &tilesets_info[lookup.tileset];
+
+                Rectangle src_rect = lookup.src;
+
+                if (CookedTileFlag_FlipH & tile_flags)
+                    src_rect.width *= -1;
+
+                if (CookedTileFlag_FlipV & tile_flags)
+                    src_rect.height *= -1;
+
+                float tile_rotation = 0.0;
+                if (CookedTileFlag_FlipDiagonal & tile_flags)
+                {
+                    tile_rotation = 90.f;
+                }
 
-            layer_obj = layer_obj->next;
+                // Position within the chunk's slot
+                Rectangle dest_rect = {chunk.slot.x + (float)(column - first_column) * tile_w + tile_w / 2.f,
+                                       chunk.slot.y + (float)(row - first_row) * tile_h + tile_h / 2.f,
+                                       (float)tile_w,
+                                       (float)tile_h};
+
+                // Add the tile to the batch
+                DrawTexturePro(this_tile_info->tex, src_rect, dest_rect, {tile_w / 2.f, tile_h / 2.f}, tile_rotation, ColorAlpha(WHITE, layer.opacity));
+                CountDraw(this_tile_info->tex.id);
+                chunk_stats.tiles_drawn++;
+                frame_stats.pixels += tile_w * tile_h;
+            }
         }
     }
 
-    // Add damage
-    // --------------------------------------------------------------------------------------
-    else if (std::string("Damage") == layer->name.ptr)
-    {
-        cute_tiled_object_t *layer_obj = layer->objects;
+    EndTextureMode();
+    CountBatchBreak();
 
-        // Iterate over each collider object
-        while (layer_obj)
-        {
-            // Set all of the grid spaces within the collider to damage cell
-            for (float temp_w = 0; temp_w < layer_obj->width; temp_w += tile_w)
-                for (float temp_h = 0; temp_h < layer_obj->height; temp_h += tile_h)
-                    (*object_map)[int((layer_obj->x + temp_w) / 8)][int((layer_obj->y + temp_h) / 8)] = GridVal_Damage;
+    chunk.dirty = false;
+
+    chunk_stats.rasterized++;
+    frame_stats.rasterized++;
+}
+
+// Free the chunk texture
+void Map::unloadChunks()
+{
+    if (chunk_texture.id != 0)
+        UnloadRenderTexture(chunk_texture);
+
+    chunk_texture = {};
+    chunk_pool.clear();
+    std::fill(chunk_slots.begin(), chunk_slots.end(), -1);
+}
 
-            layer_obj = layer_obj->next;
+// Mark a w x h block of tiles at (x, y) as changed, only the chunks holding them are re-rasterized
+void Map::invalidateTiles(int x, int y, int w, int h)
+{
+    int first_x = std::max(0, x / chunk_tiles);
+    int first_y = std::max(0, y / chunk_tiles);
+    int last_x = std::min(chunks_x - 1, (x + w - 1) / chunk_tiles);
+    int last_y = std::min(chunks_y - 1, (y + h - 1) / chunk_tiles);
+
+    for (int chunk_y = first_y; chunk_y <= last_y; chunk_y++)
+    {
+        for (int chunk_x = first_x; chunk_x <= last_x; chunk_x++)
+        {
+            // Chunks that aren't resident are rasterized fresh when they're next needed anyway
+            int32_t slot = chunk_slots[chunk_y * chunks_x + chunk_x];
+            if (slot >= 0)
+                chunk_pool[slot].dirty = true;
         }
     }
+}
+
+// Change one tile, redrawing only what it touches (a single texel in shader mode)
+void Map::setTile(uint32_t layer_index, int x, int y, uint16_t gid, uint8_t flags)
+{
+    if (layer_index >= tilelayers_info.size() || x < 0 || y < 0 || x >= map_w || y >= map_h)
+        return;
+
+    TileLayerInfo &layer = tilelayers_info[layer_index];
+    layer.tiles[map_w * y + x] = gid;
+    layer.flags[map_w * y + x] = flags;
 
-    // Add Checkpoints
-    // --------------------------------------------------------------------------------------
-    else if (std::string("Checkpoints") == layer->name.ptr)
+    // A tile from another tileset can't be drawn by the shader
+    if (gid != 0 && gid < tile_lookup.size() && tile_lookup[gid].tileset > 0)
     {
-        cute_tiled_object_t *layer_obj = layer->objects;
+        shader_supported = false;
+        if (render_mode == MapRenderMode_Shader)
+            setRenderMode(MapRenderMode_Chunks);
+    }
 
-        // Iterate over each collider object
-        while (layer_obj)
-        {
-            // Set all of the grid spaces within the collider to checkpoint
-            for (float temp_w = 0; temp_w < layer_obj->width; temp_w += tile_w)
-                for (float temp_h = 0; temp_h < layer_obj->height; temp_h += tile_h)
-                    (*object_map)[int((layer_obj->x + temp_w) / 8)][int((layer_obj->y + temp_h) / 8)] = GridVal_CheckP;
+    // Update the tile's texel
+    if (shader_supported)
+    {
+        uint8_t texel[4];
+        encodeTile(gid, flags, texel);
+        UpdateTextureRec(index_tex, Rectangle{(float)x, (float)(layer_index * map_h + y), 1, 1}, texel);
+    }
 
-            layer_obj = layer_obj->next;
-        }
+    invalidateTiles(x, y, 1, 1);
+}
+
+// Update the tile layers to a re-cooked version of the level, only re-drawing tiles that changed
+int Map::reloadTiles(const CookedLevel &cooked)
+{
+    const CookedLevelHeader &header = cooked.header();
+    if (header.width != map_w || header.height != map_h || header.tile_w != tile_w || header.tile_h != tile_h ||
+        header.layer_count != tilelayers_info.size() || header.tileset_count != tilesets_info.size())
+        return -1;
+
+    // Tiles are matched to tilesets by GID, so the tilesets have to line up
+    for (uint32_t i = 0; i < header.tileset_count; i++)
+    {
+        const CookedTileset &tileset = cooked.tileset(i);
+        const CookedTileset &current = tilesets_info[i].info;
+        if (tileset.firstgid != current.firstgid || tileset.tilecount != current.tilecount || tileset.columns != current.columns ||
+            std::strcmp(tileset.image, current.image) != 0)
+            return -1;
     }
 
-    // Add Finish
-    // --------------------------------------------------------------------------------------
-    else if (std::string("Finish") == layer->name.ptr)
+    int changed = 0;
+    for (uint32_t i = 0; i < header.layer_count; i++)
     {
-        cute_tiled_object_t *layer_obj = layer->objects;
+        const uint16_t *tiles = cooked.layerTiles(i);
+        const uint8_t *flags = cooked.layerFlags(i);
 
-        // Iterate over each collider object
-        while (layer_obj)
+        TileLayerInfo &layer = tilelayers_info[i];
+
+        for (int cell = 0; cell < map_w * map_h; cell++)
         {
-            // Set all of the grid spaces within the collider to finish cell
-            for (float temp_w = 0; temp_w < layer_obj->width; temp_w += tile_w)
-                for (float temp_h = 0; temp_h < layer_obj->height; temp_h += tile_h)
-                    (*object_map)[int((layer_obj->x + temp_w) / 8)][int((layer_obj->y + temp_h) / 8)] = GridVal_Finish;
+            uint8_t tile_flags = flags ? flags[cell] : 0;
+            if (layer.tiles[cell] == tiles[cell] && layer.flags[cell] == tile_flags)
+                continue;
 
-            layer_obj = layer_obj->next;
+            setTile(i, cell % map_w, cell / map_w, tiles[cell], tile_flags);
+            changed++;
+        }
+
+        // Opacity applies to the whole layer
+        if (layer.opacity != cooked.layer(i).opacity)
+        {
+            layer.opacity = cooked.layer(i).opacity;
+            invalidateTiles(0, 0, map_w, map_h);
+
+            if (shader_supported)
+            {
+                float layer_opacity[8] = {};
+                for (size_t l = 0; l < tilelayers_info.size(); l++)
+                    layer_opacity[l] = tilelayers_info[l].opacity;
+                SetShaderValueV(tilemap_shader, tilemap_shader_uni["layer_opacity"], layer_opacity, SHADER_UNIFORM_FLOAT, 8);
+            }
         }
     }
+
+    return changed;
 }
 
-// Draw map background to the map render texture
-void Map::update(Direction player_o, Texture2D player_tex)
+// Replace the level's static grid (after re-stamping the simulation with it)
+void Map::setLevel(const Level &new_level)
 {
-    // Begin rendering to the map texture
-    BeginTextureMode(map_target);
-    ClearBackground(GRAY);
+    level = new_level;
+}
+
+// Tilemap shader
+// ======================================================================================
 
-    // Draw map layers first
-    for (int i = 0; i < tilelayers_info.size(); i++)
+// Load the tilemap shader and upload the tile layers to the index texture
+void Map::loadTilemapShader()
+{
+    tilemap_shader = LoadShader(0, "shaders/tilemap.fs");
+
+    const char *uniforms[] = {"map_size", "layer_count", "layer_opacity", "tileset", "tileset_size", "tileset_origin", "tile_size",
+                              "tileset_columns", "tileset_margin", "tileset_spacing", "background"};
+    for (const char *uniform : uniforms)
+        tilemap_shader_uni[uniform] = GetShaderLocation(tilemap_shader, uniform);
+
+    // The shader only knows about one tileset (and has a fixed number of layers)
+    shader_supported = IsShaderValid(tilemap_shader) && tilesets_info.size() == 1 && tilelayers_info.size() <= 8;
+
+    for (const TileLayerInfo &layer : tilelayers_info)
     {
-        DrawTextureRec(tilelayers_info[i].tex.texture,
-                       Rectangle{0, 0, (float)tilelayers_info[i].tex.texture.width, (float)-tilelayers_info[i].tex.texture.height},
-                       Vector2{0, 0},
-                       ColorAlpha(WHITE, tilelayers_info[i].opacity));
+        for (uint16_t gid : layer.tiles)
+        {
+            if (gid != 0 && gid < tile_lookup.size() && tile_lookup[gid].tileset > 0)
+                shader_supported = false;
+        }
     }
 
-    // Draw colliders and player
-    for (int i = 0; i < (*object_map).size(); i++)
+    index_tex = {};
+    if (!shader_supported)
+        return;
+
+    // Every layer, one texel per tile
+    std::vector<uint8_t> texels(map_w * map_h * tilelayers_info.size() * 4);
+    for (size_t i = 0; i < tilelayers_info.size(); i++)
     {
-        for (int j = 0; j < (*object_map)[i].size(); j++)
-        {
-            switch ((*object_map)[i][j])
-            {
-            case GridVal_Player:
-            {
-                float player_rot = 0;
+        const TileLayerInfo &layer = tilelayers_info[i];
+        uint8_t *layer_texels = texels.data() + i * map_w * map_h * 4;
 
-                switch (player_o)
-                {
-                case Direction_Down:
-                    player_rot = 0.f;
-                    break;
-                case Direction_Up:
-                    player_rot = 180.f;
-                    break;
-                case Direction_Left:
-                    player_rot = 270.f;
-                    break;
-                case Direction_Right:
-                    player_rot = 90.f;
-                    break;
-
-                default:
-                    break;
-                }
+        for (int cell = 0; cell < map_w * map_h; cell++)
+            encodeTile(layer.tiles[cell], layer.flags[cell], layer_texels + cell * 4);
+    }
 
-                DrawTexturePro(player_tex,
-                               Rectangle{0, 0, 8, 8},
-                               Rectangle{i * 8.f + tile_w / 2.f, j * 8.f + tile_h / 2.f, 8, 8},
-                               {tile_w / 2.f, tile_h / 2.f}, player_rot, WHITE);
-            }
-            break;
+    Image index_img = {texels.data(), map_w, (int)(map_h * tilelayers_info.size()), 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8};
+    index_tex = LoadTextureFromImage(index_img);
+
+    // Texels are looked up exactly, never blended
+    SetTextureFilter(index_tex, TEXTURE_FILTER_POINT);
+    SetTextureWrap(index_tex, TEXTURE_WRAP_CLAMP);
+
+    // Uniforms that don't change
+    const TilesetInfo &ts_info = tilesets_info[0];
+
+    float map_size[2] = {(float)map_w, (float)map_h};
+    int layer_count = (int)tilelayers_info.size();
+    float layer_opacity[8] = {};
+    for (size_t i = 0; i < tilelayers_info.size(); i++)
+        layer_opacity[i] = tilelayers_info[i].opacity;
+
+    float tileset_size[2] = {(float)ts_info.tex.width, (float)ts_info.tex.height};
+    float tileset_origin[2] = {ts_info.origin.x, ts_info.origin.y};
+    float tile_size[2] = {(float)ts_info.info.tile_w, (float)ts_info.info.tile_h};
+    float tileset_columns = (float)ts_info.info.columns;
+    float tileset_margin = (float)ts_info.info.margin;
+    float tileset_spacing = (float)ts_info.info.spacing;
+    Vector4 background = ColorNormalize(GRAY);
+
+    SetShaderValue(tilemap_shader, tilemap_shader_uni["map_size"], map_size, SHADER_UNIFORM_VEC2);
+    SetShaderValue(tilemap_shader, tilemap_shader_uni["layer_count"], &layer_count, SHADER_UNIFORM_INT);
+    SetShaderValueV(tilemap_shader, tilemap_shader_uni["layer_opacity"], layer_opacity, SHADER_UNIFORM_FLOAT, 8);
+    SetShaderValue(tilemap_shader, tilemap_shader_uni["tileset_size"], tileset_size, SHADER_UNIFORM_VEC2);
+    SetShaderValue(tilemap_shader, tilemap_shader_uni["tileset_origin"], tileset_origin, SHADER_UNIFORM_VEC2);
+    SetShaderValue(tilemap_shader, tilemap_shader_uni["tile_size"], tile_size, SHADER_UNIFORM_VEC2);
+    SetShaderValue(tilemap_shader, tilemap_shader_uni["tileset_columns"], &tileset_columns, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(tilemap_shader, tilemap_shader_uni["tileset_margin"], &tileset_margin, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(tilemap_shader, tilemap_shader_uni["tileset_spacing"], &tileset_spacing, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(tilemap_shader, tilemap_shader_uni["background"], &background, SHADER_UNIFORM_VEC4);
+}
 
-                // Draw colliders
-            case GridVal_SolidBlock:
-            {
-                // DrawRectangleLines(i * 8, j * 8, 8, 8, ColorAlpha(BLUE, 0.8));
-            }
-            break;
+// Index texel for a tile
+void Map::encodeTile(uint16_t gid, uint8_t flags, uint8_t texel[4])
+{
+    // Tile number in the (only) tileset, + 1 so 0 stays empty
+    uint32_t tile = 0;
+    if (gid != 0 && gid < tile_lookup.size() && tile_lookup[gid].tileset == 0)
+        tile = gid - tilesets_info[0].info.firstgid + 1;
+
+    texel[0] = (uint8_t)(tile & 0xFF);
+    texel[1] = (uint8_t)(tile >> 8);
+    texel[2] = flags;
+    texel[3] = 255;
+}
 
-            case GridVal_Empty:
-            default:
-                break;
-            }
+// Draw the map with the tilemap shader
+void Map::drawTilemapShader(Rectangle dest, Rectangle view)
+{
+    // One quad over the whole map, the fragment shader only runs for the part on screen
+    BeginShaderMode(tilemap_shader);
+    SetShaderValueTexture(tilemap_shader, tilemap_shader_uni["tileset"], tilesets_info[0].tex);
+    CountBatchBreak();
+    DrawTexturePro(index_tex, Rectangle{0, 0, (float)map_w, (float)map_h}, dest, Vector2{0, 0}, 0.0, WHITE);
+    CountDraw(index_tex.id);
+    EndShaderMode();
+    CountBatchBreak();
+
+    Rectangle on_screen = GetCollisionRec(dest, view);
+    frame_stats.draw_calls++;
+    frame_stats.pixels += (uint64_t)(on_screen.width * on_screen.height);
+}
+
+// Switch how the map is drawn, returns false if the map can't be drawn that way
+bool Map::setRenderMode(MapRenderMode mode)
+{
+    if (mode == MapRenderMode_Shader && !shader_supported)
+        return false;
+
+    render_mode = mode;
+
+    // The shader needs no chunk textures
+    if (render_mode == MapRenderMode_Shader)
+        unloadChunks();
+
+    return true;
+}
+
+MapRenderMode Map::getRenderMode()
+{
+    return render_mode;
+}
+
+// Drawing
+// ======================================================================================
+
+// Draw the visible chunks of the map at dest, and the player (player_src in player_tex) on top
+void Map::draw(Rectangle dest, Rectangle view, Direction player_o, Texture2D player_tex, Rectangle player_src, Vector2i player_pos)
+{
+    chunk_stats.drawn = 0;
+    chunk_stats.resident = (uint32_t)chunk_pool.size();
+
+    if (dest.width <= 0 || dest.height <= 0)
+        return;
+
+    // Map pixels to dest
+    float scale_x = dest.width / (map_w * tile_w);
+    float scale_y = dest.height / (map_h * tile_h);
+
+    int first_x, first_y, last_x, last_y;
+    visibleChunks(dest, view, first_x, first_y, last_x, last_y);
+
+    // The shader draws every layer in one pass
+    if (render_mode == MapRenderMode_Shader)
+        drawTilemapShader(dest, view);
+
+    // Otherwise draw the chunks that are on screen
+    for (int chunk_y = first_y; chunk_y <= last_y && render_mode == MapRenderMode_Chunks; chunk_y++)
+    {
+        for (int chunk_x = first_x; chunk_x <= last_x; chunk_x++)
+        {
+            int32_t slot = chunk_slots[chunk_y * chunks_x + chunk_x];
+            if (slot < 0)
+                continue;
+
+            // Chunks on the right and bottom edges are only partly used
+            float chunk_px_w = (float)(std::min(chunk_tiles, map_w - chunk_x * chunk_tiles) * tile_w);
+            float chunk_px_h = (float)(std::min(chunk_tiles, map_h - chunk_y * chunk_tiles) * tile_h);
+
+            // Render textures are upside down, so the slot is mirrored vertically in the texture
+            const Texture2D &tex = chunk_texture.texture;
+            const Rectangle &chunk_slot = chunk_pool[slot].slot;
+            Rectangle src = {chunk_slot.x, (float)tex.height - chunk_slot.y - chunk_px_h, chunk_px_w, -chunk_px_h};
+
+            // Edges are computed the same way for neighbouring chunks, so there are no seams
+            Rectangle chunk_dest = {dest.x + chunk_x * chunk_tiles * tile_w * scale_x,
+                                    dest.y + chunk_y * chunk_tiles * tile_h * scale_y,
+                                    chunk_px_w * scale_x,
+                                    chunk_px_h * scale_y};
+
+            DrawTexturePro(tex, src, chunk_dest, Vector2{0, 0}, 0.0, WHITE);
+            CountDraw(tex.id);
+            chunk_stats.drawn++;
+
+            // Only the part on screen is filled
+            Rectangle on_screen = GetCollisionRec(chunk_dest, view);
+            frame_stats.draw_calls++;
+            frame_stats.pixels += (uint64_t)(on_screen.width * on_screen.height);
         }
     }
 
-    EndTextureMode();
+    // Draw the player
+    float player_rot = 0;
+
+    switch (player_o)
+    {
+    case Direction_Down:
+        player_rot = 0.f;
+        break;
+    case Direction_Up:
+        player_rot = 180.f;
+        break;
+    case Direction_Left:
+        player_rot = 270.f;
+        break;
+    case Direction_Right:
+        player_rot = 90.f;
+        break;
+
+    default:
+        break;
+    }
+
+    DrawTexturePro(player_tex,
+                   player_src,
+                   Rectangle{dest.x + (player_pos.x * tile_w + tile_w / 2.f) * scale_x,
+                             dest.y + (player_pos.y * tile_h + tile_h / 2.f) * scale_y,
+                             tile_w * scale_x,
+                             tile_h * scale_y},
+                   {tile_w / 2.f * scale_x, tile_h / 2.f * scale_y}, player_rot, WHITE);
+    CountDraw(player_tex.id);
+
+    frame_stats.draw_calls++;
+    frame_stats.pixels += (uint64_t)(tile_w * scale_x * tile_h * scale_y);
+}
+
+// Returns the level's static grid
+const Level &Map::getLevel()
+{
+    return level;
+}
+
+// Returns the map's size in pixels (before scaling)
+Vector2 Map::getPixelSize()
+{
+    return Vector2{(float)(map_w * tile_w), (float)(map_h * tile_h)};
+}
+
+// Returns how long loading the map took
+const MapLoadStats &Map::getLoadStats()
+{
+    return load_stats;
+}
+
+// Returns the chunk streaming counters
+const MapChunkStats &Map::getChunkStats()
+{
+    return chunk_stats;
 }
 
-// Returns the map's render texture
-RenderTexture2D Map::getRenderTexture()
+// Returns the drawing work done so far this frame
+const MapFrameStats &Map::getFrameStats()
 {
-    return map_target;
+    return frame_stats;
 }
@@ -0,0 +1,229 @@
+#include "MapLoader.hpp"
+
+// Map Data
+// ==================================================
+
+MapData::MapData()
+{
+    level_hash = 0;
+
+    level_ms = 0.0;
+    tilesets_ms = 0.0;
+    solve_ms = 0.0;
+}
+
+// Free any tileset images that were never uploaded
+MapData::~MapData()
+{
+    for (Image &img : tileset_images)
+        UnloadImage(img);
+}
+
+// Par Time
+// ==================================================
+
+// Solver settings for the par time shown in game
+SolverOptions parSolverOptions()
+{
+    SolverOptions options;
+    options.visit_all_checkpoints = true;
+    return options;
+}
+
+// Map Loader
+// ==================================================
+
+MapLoader::MapLoader(const SpriteAtlas *atlas)
+{
+    this->atlas = atlas;
+
+    stage = MapLoadStage_Idle;
+    failed = false;
+}
+
+MapLoader::~MapLoader()
+{
+    join();
+}
+
+// Wait for the worker to finish
+void MapLoader::join()
+{
+#if CATTOWER_THREADED_LOADING
+    if (worker.joinable())
+        worker.join();
+#endif
+}
+
+// Start loading a level, cooking the Tiled JSON in memory if there's no cooked file
+void MapLoader::start(const std::string &cooked_path, const std::string &json_path)
+{
+    // Anything still loading is finished (and dropped) first
+    join();
+
+    this->cooked_path = cooked_path;
+    this->json_path = json_path;
+
+    data = std::make_unique<MapData>();
+    stage = MapLoadStage_Level;
+    failed = false;
+
+#if CATTOWER_THREADED_LOADING
+    // Run every stage on the worker, publishing each as it starts
+    worker = std::thread([this]()
+                         {
+                             MapLoadStage current = MapLoadStage_Level;
+                             while (current != MapLoadStage_Done && current != MapLoadStage_Failed)
+                             {
+                                 current = runStage(current);
+                                 stage = current;
+                             } });
+#endif
+}
+
+// Call once a frame, returns true once loading has finished (or failed)
+bool MapLoader::poll()
+{
+    MapLoadStage current = getStage();
+
+#if !CATTOWER_THREADED_LOADING
+    // No thread, so spread the stages over frames to keep drawing in between
+    if (current != MapLoadStage_Idle && current != MapLoadStage_Done && current != MapLoadStage_Failed)
+    {
+        current = runStage(current);
+        stage = current;
+    }
+#endif
+
+    return current == MapLoadStage_Done || current == MapLoadStage_Failed;
+}
+
+// Run one stage of loading, returns the stage after it
+MapLoadStage MapLoader::runStage(MapLoadStage current)
+{
+    double start_time = GetTime();
+
+    switch (current)
+    {
+    case MapLoadStage_Level:
+    {
+        // Cooked by the asset pipeline (mapped straight from the file, no parsing)
+        if (!data->cooked.open(cooked_path.c_str()))
+        {
+            // Otherwise parse the Tiled JSON and cook it now
+            std::vector<uint8_t> cooked_bytes;
+            std::string error;
+            if (!cookLevelFile(json_path.c_str(), cooked_bytes, error) || !data->cooked.openMemory(cooked_bytes.data(), cooked_bytes.size()))
+            {
+                TraceLog(LOG_ERROR, "MAP: Could not load %s (%s)", json_path.c_str(), error.c_str());
+                return MapLoadStage_Failed;
+            }
+        }
+
+        data->level_ms = (GetTime() - start_time) * 1000.0;
+        return MapLoadStage_Tilesets;
+    }
+
+    case MapLoadStage_Tilesets:
+    {
+        // Decode the images now, only the upload is left for the main thread
+        for (uint32_t i = 0; i < data->cooked.header().tileset_count; i++)
+        {
+            // Already on the GPU in the sprite atlas
+            Rectangle atlas_rect;
+            if (atlas && FindAtlasSprite(*atlas, AtlasSpriteName(data->cooked.tileset(i).image), &atlas_rect))
+            {
+                data->tileset_images.push_back(Image{});
+                continue;
+            }
+
+            data->tileset_images.push_back(LoadImage(data->cooked.tileset(i).image));
+        }
+
+        data->tilesets_ms = (GetTime() - start_time) * 1000.0;
+        return MapLoadStage_Grid;
+    }
+
+    case MapLoadStage_Grid:
+    {
+        // Colliders, damage, checkpoints and finish are already rasterized into the cooked grid
+        data->cooked.toLevel(data->level);
+        data->level_hash = hashLevel(data->level);
+
+        data->level_ms += (GetTime() - start_time) * 1000.0;
+        return MapLoadStage_Solve;
+    }
+
+    case MapLoadStage_Solve:
+    {
+        // Solve the level for its par time (takes a few milliseconds)
+        SlideGraph slide_graph;
+        slide_graph.build(data->level);
+        data->solution = solveLevel(slide_graph, data->level.spawn_pos, parSolverOptions());
+
+        data->solve_ms = (GetTime() - start_time) * 1000.0;
+        return MapLoadStage_Done;
+    }
+
+    default:
+        return current;
+    }
+}
+
+MapLoadStage MapLoader::getStage() const
+{
+    return (MapLoadStage)stage.load();
+}
+
+// How far through loading (0-1), weighted by roughly how long each stage takes
+float MapLoader::getProgress() const
+{
+    switch (getStage())
+    {
+    case MapLoadStage_Level:
+        return 0.f;
+    case MapLoadStage_Tilesets:
+        return 0.1f;
+    case MapLoadStage_Grid:
+        return 0.7f;
+    case MapLoadStage_Solve:
+        return 0.8f;
+    case MapLoadStage_Done:
+        return 1.f;
+    default:
+        return 0.f;
+    }
+}
+
+bool MapLoader::isLoading() const
+{
+    MapLoadStage current = getStage();
+    return current != MapLoadStage_Idle && current != MapLoadStage_Done && current != MapLoadStage_Failed;
+}
+
+// Did the last load fail (stays true once its result has been taken)
+bool MapLoader::hasFailed() const
+{
+    return failed;
+}
+
+// Take the loaded data (nullptr if loading failed or hasn't finished)
+std::unique_ptr<MapData> MapLoader::take()
+{
+    MapLoadStage current = getStage();
+    if (current != MapLoadStage_Done && current != MapLoadStage_Failed)
+        return nullptr;
+
+    // The worker has published its last stage, so it's done with data
+    join();
+    stage = MapLoadStage_Idle;
+
+    if (current == MapLoadStage_Failed)
+    {
+        failed = true;
+        data.reset();
+        return nullptr;
+    }
+
+    return std::move(data);
+}
@@ -22,12 +22,20 @@ void Particle::draw()
     DrawRectangle(position.x, position.y, size, size, BLACK);
 }
 
+float ParticleSystem::density = 1.f;
+
 ParticleSystem::ParticleSystem(Vector2 &pos)
 {
-    for (int i = 0; i < 10; i++)
+    int count = (int)(base_particle_count * density + 0.5f);
+    for (int i = 0; i < count; i++)
         particles.emplace_back(pos);
 }
 
+void ParticleSystem::setDensity(float density)
+{
+    ParticleSystem::density = std::clamp(density, 0.f, 1.f);
+}
+
 void ParticleSystem::update()
 {
     particles.erase(
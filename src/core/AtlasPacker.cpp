@@ -0,0 +1,60 @@
+#include "core/AtlasPacker.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+// Pack sprites into one atlas with a shelf packer
+bool packAtlas(std::vector<PackedRect> &rects, int32_t padding, int32_t max_size, int32_t &atlas_w, int32_t &atlas_h)
+{
+    atlas_w = 0;
+    atlas_h = 0;
+
+    // Shelves are as wide as the widest sprite (the tileset, for this game's art)
+    for (const PackedRect &rect : rects)
+        atlas_w = std::max(atlas_w, rect.w);
+
+    if (atlas_w > max_size)
+        return false;
+
+    // Tallest first keeps the shelves tight
+    std::vector<size_t> order(rects.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b)
+              {
+                  if (rects[a].h != rects[b].h)
+                      return rects[a].h > rects[b].h;
+                  if (rects[a].w != rects[b].w)
+                      return rects[a].w > rects[b].w;
+                  return a < b; });
+
+    int32_t shelf_x = 0;
+    int32_t shelf_y = 0;
+    int32_t shelf_h = 0;
+
+    for (size_t i : order)
+    {
+        PackedRect &rect = rects[i];
+
+        // Start a new shelf when this one is full
+        if (shelf_x > 0 && shelf_x + rect.w > atlas_w)
+        {
+            shelf_y += shelf_h + padding;
+            shelf_x = 0;
+            shelf_h = 0;
+        }
+
+        rect.x = shelf_x;
+        rect.y = shelf_y;
+
+        shelf_x += rect.w + padding;
+        shelf_h = std::max(shelf_h, rect.h);
+    }
+
+    atlas_h = shelf_y + shelf_h;
+
+    // Round up to a multiple of 4 so rows stay aligned
+    atlas_w = (atlas_w + 3) & ~3;
+    atlas_h = (atlas_h + 3) & ~3;
+
+    return atlas_h <= max_size;
+}
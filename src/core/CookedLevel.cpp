@@ -0,0 +1,390 @@
+#include "core/CookedLevel.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+// Memory-mapped files (native POSIX only, everything else reads the file in one go)
+#if !defined(__EMSCRIPTEN__) && (defined(__unix__) || defined(__APPLE__))
+#define COOKED_LEVEL_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Cooking
+// ======================================================================================
+
+// Round up to the next 4-byte boundary
+static size_t align4(size_t offset)
+{
+    return (offset + 3) & ~(size_t)3;
+}
+
+// Reserve an aligned block at the end of out and return its offset
+static size_t appendBlock(std::vector<uint8_t> &out, size_t size)
+{
+    size_t offset = align4(out.size());
+    out.resize(offset + size, 0);
+    return offset;
+}
+
+// Copy a string into a fixed-size, null terminated field
+static bool copyName(char *dest, size_t dest_size, const char *src)
+{
+    if (!src)
+        src = "";
+
+    size_t len = std::strlen(src);
+    if (len >= dest_size)
+        return false;
+
+    std::memcpy(dest, src, len + 1);
+    return true;
+}
+
+// Cook a parsed Tiled map
+bool cookLevel(const cute_tiled_map_t *map, std::vector<uint8_t> &out, std::string &error)
+{
+    // Rasterize the object layers exactly as the game does
+    Level level;
+    initLevel(map, level);
+
+    uint32_t tileset_count = 0;
+    for (const cute_tiled_tileset_t *ts = map->tilesets; ts; ts = ts->next)
+        tileset_count++;
+
+    uint32_t layer_count = 0;
+    for (const cute_tiled_layer_t *layer = map->layers; layer; layer = layer->next)
+    {
+        if (!layer->type.ptr)
+            continue;
+
+        if (std::string("tilelayer") == layer->type.ptr)
+            layer_count++;
+        else if (std::string("objectgroup") == layer->type.ptr)
+            stampObjectLayer(layer, level);
+    }
+
+    // The game can't start a level without somewhere to put the player
+    if (!level.grid.inBounds(level.spawn_pos.x, level.spawn_pos.y))
+    {
+        error = "level has no Spawn object inside the map";
+        return false;
+    }
+
+    const size_t cells = level.grid.size();
+
+    // Header and tables
+    out.clear();
+    appendBlock(out, sizeof(CookedLevelHeader));
+    size_t tileset_offset = appendBlock(out, sizeof(CookedTileset) * tileset_count);
+    size_t layer_offset = appendBlock(out, sizeof(CookedTileLayer) * layer_count);
+
+    // Tilesets
+    uint32_t ts_index = 0;
+    for (const cute_tiled_tileset_t *ts = map->tilesets; ts; ts = ts->next, ts_index++)
+    {
+        CookedTileset cooked = {};
+        cooked.firstgid = ts->firstgid;
+        cooked.tilecount = ts->tilecount;
+        cooked.columns = ts->columns;
+        cooked.tile_w = ts->tilewidth;
+        cooked.tile_h = ts->tileheight;
+        cooked.margin = ts->margin;
+        cooked.spacing = ts->spacing;
+        cooked.image_w = ts->imagewidth;
+        cooked.image_h = ts->imageheight;
+
+        // The game loads tileset images by file name
+        std::string image = ts->image.ptr ? std::filesystem::path(ts->image.ptr).filename().string() : "";
+        if (!copyName(cooked.image, sizeof(cooked.image), image.c_str()))
+        {
+            error = "tileset image name too long: " + image;
+            return false;
+        }
+
+        if (ts->firstgid + ts->tilecount - 1 > 0xFFFF)
+        {
+            error = "tile GIDs don't fit in 16 bits";
+            return false;
+        }
+
+        std::memcpy(out.data() + tileset_offset + ts_index * sizeof(CookedTileset), &cooked, sizeof(cooked));
+    }
+
+    // Tile layers
+    uint32_t layer_index = 0;
+    for (const cute_tiled_layer_t *layer = map->layers; layer; layer = layer->next)
+    {
+        if (!layer->type.ptr || std::string("tilelayer") != layer->type.ptr)
+            continue;
+
+        if (layer->data_count != (int)cells)
+        {
+            error = "tile layer size doesn't match the map";
+            return false;
+        }
+
+        CookedTileLayer cooked = {};
+        cooked.opacity = layer->opacity;
+        if (!copyName(cooked.name, sizeof(cooked.name), layer->name.ptr))
+        {
+            error = "tile layer name too long";
+            return false;
+        }
+
+        // Split the GIDs from Tiled's flip flags
+        std::vector<uint16_t> tiles(cells);
+        std::vector<uint8_t> flags(cells, 0);
+        bool any_flags = false;
+
+        for (size_t i = 0; i < cells; i++)
+        {
+            uint32_t tile_data = (uint32_t)layer->data[i];
+            uint32_t gid = tile_data & 0x0FFF'FFFF;
+
+            if (gid > 0xFFFF)
+            {
+                error = "tile GIDs don't fit in 16 bits";
+                return false;
+            }
+            tiles[i] = (uint16_t)gid;
+
+            if (tile_data & 0x8000'0000)
+                flags[i] |= CookedTileFlag_FlipH;
+            if (tile_data & 0x4000'0000)
+                flags[i] |= CookedTileFlag_FlipV;
+            if (tile_data & 0x2000'0000)
+                flags[i] |= CookedTileFlag_FlipDiagonal;
+
+            any_flags |= flags[i] != 0;
+        }
+
+        cooked.tiles_offset = (uint32_t)appendBlock(out, cells * sizeof(uint16_t));
+        std::memcpy(out.data() + cooked.tiles_offset, tiles.data(), cells * sizeof(uint16_t));
+
+        if (any_flags)
+        {
+            cooked.flags_offset = (uint32_t)appendBlock(out, cells);
+            std::memcpy(out.data() + cooked.flags_offset, flags.data(), cells);
+        }
+
+        std::memcpy(out.data() + layer_offset + layer_index * sizeof(CookedTileLayer), &cooked, sizeof(cooked));
+        layer_index++;
+    }
+
+    // Rasterized grid
+    size_t grid_offset = appendBlock(out, cells);
+    std::memcpy(out.data() + grid_offset, level.grid.data(), cells);
+
+    out.resize(align4(out.size()), 0);
+
+    // Header last, now every offset is known
+    CookedLevelHeader header = {};
+    std::memcpy(header.magic, cooked_level_magic, 4);
+    header.version = cooked_level_version;
+    header.file_size = (uint32_t)out.size();
+    header.width = level.grid.width();
+    header.height = level.grid.height();
+    header.tile_w = level.tile_w;
+    header.tile_h = level.tile_h;
+    header.spawn_x = level.spawn_pos.x;
+    header.spawn_y = level.spawn_pos.y;
+    header.tileset_count = tileset_count;
+    header.tileset_offset = (uint32_t)tileset_offset;
+    header.layer_count = layer_count;
+    header.layer_offset = (uint32_t)layer_offset;
+    header.grid_offset = (uint32_t)grid_offset;
+
+    std::memcpy(out.data(), &header, sizeof(header));
+    return true;
+}
+
+// Cook a Tiled JSON map file
+bool cookLevelFile(const char *json_path, std::vector<uint8_t> &out, std::string &error)
+{
+    cute_tiled_map_t *map = cute_tiled_load_map_from_file(json_path, NULL);
+    if (!map)
+    {
+        error = std::string("could not parse ") + json_path;
+        return false;
+    }
+
+    bool ok = cookLevel(map, out, error);
+    cute_tiled_free_map(map);
+    return ok;
+}
+
+// Loading
+// ======================================================================================
+
+// Constructor
+CookedLevel::CookedLevel()
+{
+    mapping = nullptr;
+    mapping_size = 0;
+    bytes = nullptr;
+    size = 0;
+}
+
+// Destructor
+CookedLevel::~CookedLevel()
+{
+    close();
+}
+
+// Open a cooked level file
+bool CookedLevel::open(const char *path)
+{
+    close();
+
+#ifdef COOKED_LEVEL_MMAP
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    void *addr = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED)
+        return false;
+
+    mapping = addr;
+    mapping_size = (size_t)st.st_size;
+    bytes = (const uint8_t *)addr;
+    size = mapping_size;
+#else
+    FILE *file = std::fopen(path, "rb");
+    if (!file)
+        return false;
+
+    std::fseek(file, 0, SEEK_END);
+    long file_size = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+
+    if (file_size <= 0)
+    {
+        std::fclose(file);
+        return false;
+    }
+
+    // One read for the whole file
+    storage.resize((size_t)file_size);
+    bool read_ok = std::fread(storage.data(), 1, storage.size(), file) == storage.size();
+    std::fclose(file);
+    if (!read_ok)
+        return false;
+
+    bytes = storage.data();
+    size = storage.size();
+#endif
+
+    if (!validate())
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+// Use cooked bytes already in memory
+bool CookedLevel::openMemory(const uint8_t *data, size_t data_size)
+{
+    close();
+
+    storage.assign(data, data + data_size);
+    bytes = storage.data();
+    size = storage.size();
+
+    if (!validate())
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void CookedLevel::close()
+{
+#ifdef COOKED_LEVEL_MMAP
+    if (mapping)
+        munmap(mapping, mapping_size);
+#endif
+
+    mapping = nullptr;
+    mapping_size = 0;
+    storage.clear();
+    bytes = nullptr;
+    size = 0;
+}
+
+// Check the header and every offset
+bool CookedLevel::validate()
+{
+    if (size < sizeof(CookedLevelHeader))
+        return false;
+
+    const CookedLevelHeader &h = header();
+    if (std::memcmp(h.magic, cooked_level_magic, 4) != 0 || h.version != cooked_level_version || h.file_size != size)
+        return false;
+
+    if (h.width <= 0 || h.height <= 0 || h.tile_w <= 0 || h.tile_h <= 0)
+        return false;
+
+    if (h.spawn_x < 0 || h.spawn_y < 0 || h.spawn_x >= h.width || h.spawn_y >= h.height)
+        return false;
+
+    const size_t cells = (size_t)h.width * h.height;
+
+    // Does [offset, offset + block_size) lie inside the file, 4-byte aligned
+    auto inside = [&](size_t offset, size_t block_size)
+    {
+        return offset % 4 == 0 && offset <= size && block_size <= size - offset;
+    };
+
+    if (!inside(h.tileset_offset, (size_t)h.tileset_count * sizeof(CookedTileset)) ||
+        !inside(h.layer_offset, (size_t)h.layer_count * sizeof(CookedTileLayer)) ||
+        !inside(h.grid_offset, cells))
+        return false;
+
+    for (uint32_t i = 0; i < h.layer_count; i++)
+    {
+        const CookedTileLayer &l = layer(i);
+        if (!inside(l.tiles_offset, cells * sizeof(uint16_t)) || (l.flags_offset && !inside(l.flags_offset, cells)))
+            return false;
+    }
+
+    return true;
+}
+
+// Copy the static grid and spawn out into a Level
+void CookedLevel::toLevel(Level &level) const
+{
+    const CookedLevelHeader &h = header();
+
+    level.tile_w = h.tile_w;
+    level.tile_h = h.tile_h;
+    level.spawn_pos = {h.spawn_x, h.spawn_y};
+
+    level.grid.resize(h.width, h.height, GridVal_Empty);
+    std::memcpy(level.grid.data(), grid(), level.grid.size());
+}
+
+// Load just the static level from a cooked file
+bool loadCookedLevel(const char *path, Level &level)
+{
+    CookedLevel cooked;
+    if (!cooked.open(path))
+        return false;
+
+    cooked.toLevel(level);
+    return true;
+}
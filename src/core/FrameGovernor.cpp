@@ -0,0 +1,124 @@
+#include "core/FrameGovernor.hpp"
+
+#include <algorithm>
+
+FrameGovernor::FrameGovernor(int tier_count, int start_tier, FrameGovernorOptions options)
+{
+    this->options = options;
+    this->tier_count = std::max(1, tier_count);
+    tier = std::clamp(start_tier, 0, this->tier_count - 1);
+
+    frame_times.assign(std::max<size_t>(1, options.window), 0.0);
+    scratch.assign(frame_times.size(), 0.0);
+    current_percentile = 0.0;
+    step_up_delay = options.step_up_delay;
+    probing = false;
+    enabled = true;
+
+    resetWindow();
+}
+
+// Forget the window after a change
+void FrameGovernor::resetWindow()
+{
+    head = 0;
+    count = 0;
+    headroom_time = 0.0;
+}
+
+// Record a frame, returns true if the tier changed
+bool FrameGovernor::addFrame(double frame_time)
+{
+    frame_times[head] = frame_time;
+    head = (head + 1) % frame_times.size();
+    count = std::min(count + 1, frame_times.size());
+
+    // Nothing is judged until the window is full of frames from this tier
+    if (count < frame_times.size())
+        return false;
+
+    std::copy(frame_times.begin(), frame_times.end(), scratch.begin());
+    size_t rank = std::min(scratch.size() - 1, (size_t)(options.percentile * scratch.size()));
+    std::nth_element(scratch.begin(), scratch.begin() + rank, scratch.end());
+    current_percentile = scratch[rank];
+
+    if (current_percentile < options.budget * options.step_up_ratio)
+        headroom_time += frame_time;
+    else
+        headroom_time = 0.0;
+
+    if (!enabled)
+        return false;
+
+    // Over budget: one tier cheaper
+    if (current_percentile > options.budget * options.step_down_ratio && tier + 1 < tier_count)
+    {
+        // Straight back down from a step up, so wait longer before trying that again
+        if (probing)
+            step_up_delay = std::min(step_up_delay * 2.0, options.max_step_up_delay);
+
+        tier++;
+        probing = false;
+        resetWindow();
+        return true;
+    }
+
+    // A step up that has held for a full delay is settled
+    if (probing && headroom_time > step_up_delay)
+    {
+        probing = false;
+        step_up_delay = options.step_up_delay;
+    }
+
+    // Headroom for long enough: try one tier better
+    if (headroom_time > step_up_delay && tier > 0)
+    {
+        tier--;
+        probing = true;
+        resetWindow();
+        return true;
+    }
+
+    return false;
+}
+
+int FrameGovernor::getTier() const
+{
+    return tier;
+}
+
+int FrameGovernor::getTierCount() const
+{
+    return tier_count;
+}
+
+// Force a tier (the governor carries on from there if it's enabled)
+void FrameGovernor::setTier(int new_tier)
+{
+    tier = std::clamp(new_tier, 0, tier_count - 1);
+    probing = false;
+    step_up_delay = options.step_up_delay;
+    resetWindow();
+}
+
+void FrameGovernor::setEnabled(bool enabled)
+{
+    this->enabled = enabled;
+    resetWindow();
+}
+
+bool FrameGovernor::isEnabled() const
+{
+    return enabled;
+}
+
+// Percentile of recent frame times (0 until the window has filled once)
+double FrameGovernor::getPercentile() const
+{
+    return current_percentile;
+}
+
+const FrameGovernorOptions &FrameGovernor::getOptions() const
+{
+    return options;
+}
@@ -0,0 +1,227 @@
+#include "core/GridBitboards.hpp"
+
+// Bit scan helpers
+// ======================================================================================
+
+// Count trailing zeros (x must be non-zero)
+static inline int ctz64(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    int n = 0;
+    while (!(x & 1))
+    {
+        x >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+// Count leading zeros (x must be non-zero)
+static inline int clz64(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(x);
+#else
+    int n = 0;
+    while (!(x & (1ull << 63)))
+    {
+        x <<= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+// GridBitboards
+// ======================================================================================
+
+// Constructor
+GridBitboards::GridBitboards()
+{
+    w = 0;
+    h = 0;
+    row_words = 0;
+    col_words = 0;
+}
+
+// Layer a GridVal is stored in
+GridBitboards::Layer GridBitboards::layerOf(uint8_t val)
+{
+    switch (val)
+    {
+    case GridVal_SolidBlock:
+        return Layer_SolidBlock;
+    case GridVal_Damage:
+        return Layer_Damage;
+    case GridVal_CheckP:
+        return Layer_CheckP;
+    case GridVal_Finish:
+        return Layer_Finish;
+    default:
+        return Layer_Count;
+    }
+}
+
+// Rebuild every layer from grid
+void GridBitboards::build(const GridBuffer<uint8_t> &grid)
+{
+    w = grid.width();
+    h = grid.height();
+    row_words = (w + 63) / 64;
+    col_words = (h + 63) / 64;
+
+    for (int layer = 0; layer < Layer_Count; layer++)
+    {
+        rows[layer].assign((std::size_t)row_words * h, 0);
+        cols[layer].assign((std::size_t)col_words * w, 0);
+    }
+
+    for (int y = 0; y < h; y++)
+        for (int x = 0; x < w; x++)
+        {
+            Layer layer = layerOf(grid(x, y));
+            if (layer == Layer_Count)
+                continue;
+
+            setBit(layer, x, y, true);
+            setBit(Layer_Blocking, x, y, true);
+        }
+}
+
+// Set or clear one bit in both the row and column boards of a layer
+void GridBitboards::setBit(Layer layer, int x, int y, bool on)
+{
+    uint64_t &row_word = rows[layer][(std::size_t)y * row_words + x / 64];
+    uint64_t &col_word = cols[layer][(std::size_t)x * col_words + y / 64];
+
+    if (on)
+    {
+        row_word |= 1ull << (x % 64);
+        col_word |= 1ull << (y % 64);
+    }
+    else
+    {
+        row_word &= ~(1ull << (x % 64));
+        col_word &= ~(1ull << (y % 64));
+    }
+}
+
+// Update a single cell after it changed in the grid
+void GridBitboards::setCell(Vector2i pos, uint8_t val)
+{
+    Layer new_layer = layerOf(val);
+
+    for (int layer = 0; layer < Layer_Blocking; layer++)
+        setBit((Layer)layer, pos.x, pos.y, layer == new_layer);
+
+    setBit(Layer_Blocking, pos.x, pos.y, new_layer != Layer_Count);
+}
+
+// GridVal stored at pos
+GridVal GridBitboards::cellAt(Vector2i pos) const
+{
+    std::size_t word = (std::size_t)pos.y * row_words + pos.x / 64;
+    uint64_t bit = 1ull << (pos.x % 64);
+
+    if (!(rows[Layer_Blocking][word] & bit))
+        return GridVal_Empty;
+    if (rows[Layer_SolidBlock][word] & bit)
+        return GridVal_SolidBlock;
+    if (rows[Layer_Damage][word] & bit)
+        return GridVal_Damage;
+    if (rows[Layer_CheckP][word] & bit)
+        return GridVal_CheckP;
+    return GridVal_Finish;
+}
+
+// Row y of a layer
+const uint64_t *GridBitboards::row(Layer layer, int y) const
+{
+    return rows[layer].data() + (std::size_t)y * row_words;
+}
+
+// Column x of a layer
+const uint64_t *GridBitboards::column(Layer layer, int x) const
+{
+    return cols[layer].data() + (std::size_t)x * col_words;
+}
+
+// Index of the first set bit after from, or len if there is none
+int GridBitboards::findNext(const uint64_t *line, int len, int from)
+{
+    int start = from + 1;
+    if (start >= len)
+        return len;
+
+    int word = start / 64;
+    int words = (len + 63) / 64;
+
+    // Mask off the bits at or before from in the first word
+    uint64_t bits = line[word] & (~0ull << (start % 64));
+
+    while (!bits)
+    {
+        if (++word >= words)
+            return len;
+        bits = line[word];
+    }
+
+    return word * 64 + ctz64(bits);
+}
+
+// Index of the last set bit before from, or -1 if there is none
+int GridBitboards::findPrev(const uint64_t *line, int from)
+{
+    int end = from - 1;
+    if (end < 0)
+        return -1;
+
+    int word = end / 64;
+
+    // Mask off the bits at or after from in the first word
+    uint64_t bits = line[word] & (~0ull >> (63 - end % 64));
+
+    while (!bits)
+    {
+        if (--word < 0)
+            return -1;
+        bits = line[word];
+    }
+
+    return word * 64 + 63 - clz64(bits);
+}
+
+// Bit-scan slide kernel
+MoveInfo GridBitboards::slide(Vector2i pos, Direction dir) const
+{
+    Vector2i block = pos;
+
+    switch (dir)
+    {
+    case Direction_Left:
+        block.x = findPrev(row(Layer_Blocking, pos.y), pos.x);
+        break;
+    case Direction_Right:
+        block.x = findNext(row(Layer_Blocking, pos.y), w, pos.x);
+        break;
+    case Direction_Up:
+        block.y = findPrev(column(Layer_Blocking, pos.x), pos.y);
+        break;
+    case Direction_Down:
+        block.y = findNext(column(Layer_Blocking, pos.x), h, pos.y);
+        break;
+    default:
+        return MoveInfo{pos, GridVal_Empty};
+    }
+
+    // Stop in the cell before the blocker
+    Vector2i stop = {block.x + (pos.x > block.x) - (pos.x < block.x),
+                     block.y + (pos.y > block.y) - (pos.y < block.y)};
+
+    // The grid edge counts as a solid block
+    bool in_bounds = block.x >= 0 && block.x < w && block.y >= 0 && block.y < h;
+    return MoveInfo{stop, in_bounds ? cellAt(block) : GridVal_SolidBlock};
+}
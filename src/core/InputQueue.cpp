@@ -0,0 +1,97 @@
+#include "core/InputQueue.hpp"
+
+#include <algorithm>
+
+// Constructor
+InputQueue::InputQueue(size_t depth)
+{
+    setDepth(depth);
+    resetLatency();
+}
+
+// Change how many events can be buffered (clears the queue)
+void InputQueue::setDepth(size_t depth)
+{
+    events.assign(std::max<size_t>(depth, 1), InputEvent{SimInput_None, 0.0});
+    head = 0;
+    count = 0;
+    dropped = 0;
+}
+
+size_t InputQueue::getDepth() const
+{
+    return events.size();
+}
+
+// Queue an event, returns false (and drops it) if the buffer is full
+bool InputQueue::push(SimInput input, double time)
+{
+    if (count == events.size())
+    {
+        dropped++;
+        return false;
+    }
+
+    events[(head + count) % events.size()] = InputEvent{input, time};
+    count++;
+    return true;
+}
+
+// Take the oldest event, returns false if the queue is empty
+bool InputQueue::pop(InputEvent &event)
+{
+    if (count == 0)
+        return false;
+
+    event = events[head];
+    head = (head + 1) % events.size();
+    count--;
+    return true;
+}
+
+// Throw away every queued event
+void InputQueue::clear()
+{
+    head = 0;
+    count = 0;
+}
+
+size_t InputQueue::size() const
+{
+    return count;
+}
+
+bool InputQueue::empty() const
+{
+    return count == 0;
+}
+
+unsigned long InputQueue::getDropped() const
+{
+    return dropped;
+}
+
+// Latency
+// ======================================================================================
+
+// Record how long an event waited between being pressed and moving the player
+void InputQueue::recordLatency(double seconds)
+{
+    latency.last = seconds;
+    latency.min = latency.count == 0 ? seconds : std::min(latency.min, seconds);
+    latency.max = latency.count == 0 ? seconds : std::max(latency.max, seconds);
+
+    // Running mean
+    latency.count++;
+    latency.mean += (seconds - latency.mean) / (double)latency.count;
+}
+
+void InputQueue::resetLatency()
+{
+    latency = LatencyStats{0.0, 0.0, 0.0, 0.0, 0};
+}
+
+const LatencyStats &InputQueue::getLatency() const
+{
+    return latency;
+}
@@ -0,0 +1,86 @@
+// Tiled loader implementation (only once)
+#define CUTE_TILED_IMPLEMENTATION
+#include "core/Level.hpp"
+
+#include <string>
+
+// Set every cell covered by a Tiled object to val
+static void stampObject(const cute_tiled_object_t *obj, uint8_t val, Level &level)
+{
+    for (float temp_w = 0; temp_w < obj->width; temp_w += level.tile_w)
+        for (float temp_h = 0; temp_h < obj->height; temp_h += level.tile_h)
+            level.grid.at(int((obj->x + temp_w) / level.tile_w), int((obj->y + temp_h) / level.tile_h)) = val;
+}
+
+// Set up an empty level sized to a Tiled map
+void initLevel(const cute_tiled_map_t *map, Level &level)
+{
+    level.tile_w = map->tilewidth;
+    level.tile_h = map->tileheight;
+    level.grid.resize(map->width, map->height, GridVal_Empty);
+    level.spawn_pos = {-1, -1};
+}
+
+// Rasterize one Tiled object layer into the level
+bool stampObjectLayer(const cute_tiled_layer_t *layer, Level &level)
+{
+    if (!layer->name.ptr)
+        return false;
+
+    std::string layer_name = layer->name.ptr;
+
+    // Add the player spawn
+    // --------------------------------------------------------------------------------------
+    if (layer_name == "Objects")
+    {
+        bool found_spawn = false;
+
+        for (const cute_tiled_object_t *layer_obj = layer->objects; layer_obj; layer_obj = layer_obj->next)
+        {
+            if (layer_obj->name.ptr && std::string("Spawn") == layer_obj->name.ptr)
+            {
+                level.spawn_pos = {int(layer_obj->x / level.tile_w), int(layer_obj->y / level.tile_h)};
+                found_spawn = true;
+            }
+        }
+
+        return found_spawn;
+    }
+
+    // Add solid bodies, damage, checkpoints and finish cells
+    // --------------------------------------------------------------------------------------
+    uint8_t val;
+    if (layer_name == "Collision")
+        val = GridVal_SolidBlock;
+    else if (layer_name == "Damage")
+        val = GridVal_Damage;
+    else if (layer_name == "Checkpoints")
+        val = GridVal_CheckP;
+    else if (layer_name == "Finish")
+        val = GridVal_Finish;
+    else
+        return false;
+
+    // Set all of the grid spaces within each object to val
+    for (const cute_tiled_object_t *layer_obj = layer->objects; layer_obj; layer_obj = layer_obj->next)
+        stampObject(layer_obj, val, level);
+
+    return false;
+}
+
+// Load every object layer of a Tiled JSON map into level
+bool loadLevel(const char *path, Level &level)
+{
+    cute_tiled_map_t *map = cute_tiled_load_map_from_file(path, NULL);
+    if (!map)
+        return false;
+
+    initLevel(map, level);
+
+    for (cute_tiled_layer_t *layer = map->layers; layer; layer = layer->next)
+        if (layer->type.ptr && std::string("objectgroup") == layer->type.ptr)
+            stampObjectLayer(layer, level);
+
+    cute_tiled_free_map(map);
+    return true;
+}
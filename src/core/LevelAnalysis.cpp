@@ -0,0 +1,194 @@
+#include "core/LevelAnalysis.hpp"
+
+#include <algorithm>
+#include <utility>
+
+// Does a slide move the player to another cell (as opposed to ending the run or killing them)
+static bool isMoveEdge(const SlideGraph::Edge &edge, int from)
+{
+    return edge.to != from && edge.blocked_by != GridVal_Damage && edge.blocked_by != GridVal_Finish;
+}
+
+// Analyze reachability, softlocks, checkpoints and forced deaths on a level's slide graph
+LevelReport analyzeLevel(const SlideGraph &graph, Vector2i spawn)
+{
+    LevelReport report = {};
+
+    report.has_spawn = spawn.x >= 0 && spawn.y >= 0 && spawn.x < graph.width() && spawn.y < graph.height();
+    if (!report.has_spawn)
+        return report;
+
+    const int cell_count = graph.cellCount();
+    const int start = graph.cellIndex(spawn);
+
+    // Forward reachability from spawn
+    //--------------------------------------------------------------------------------------
+    std::vector<uint8_t> reachable(cell_count, 0);
+    std::vector<int> order;
+    order.push_back(start);
+    reachable[start] = 1;
+
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        const int cell = order[i];
+        for (int dir = 0; dir < 4; dir++)
+        {
+            const SlideGraph::Edge &edge = graph.edge(cell, (Direction)dir);
+            if (isMoveEdge(edge, cell) && !reachable[edge.to])
+            {
+                reachable[edge.to] = 1;
+                order.push_back(edge.to);
+            }
+        }
+    }
+    report.reachable_cells = (int)order.size();
+
+    // Strongly connected components (iterative Tarjan over the reachable cells)
+    //--------------------------------------------------------------------------------------
+    std::vector<int> index(cell_count, -1);
+    std::vector<int> lowlink(cell_count, 0);
+    std::vector<int> component(cell_count, -1);
+    std::vector<uint8_t> on_stack(cell_count, 0);
+    std::vector<int> scc_stack;
+
+    // Call stack of (cell, next direction to look at)
+    std::vector<std::pair<int, int>> call_stack;
+    int next_index = 0;
+
+    for (int root : order)
+    {
+        if (index[root] != -1)
+            continue;
+
+        call_stack.push_back({root, 0});
+        index[root] = lowlink[root] = next_index++;
+        scc_stack.push_back(root);
+        on_stack[root] = 1;
+
+        while (!call_stack.empty())
+        {
+            int cell = call_stack.back().first;
+            int &dir = call_stack.back().second;
+
+            if (dir < 4)
+            {
+                const SlideGraph::Edge &edge = graph.edge(cell, (Direction)dir++);
+                if (!isMoveEdge(edge, cell))
+                    continue;
+
+                if (index[edge.to] == -1)
+                {
+                    // Recurse
+                    index[edge.to] = lowlink[edge.to] = next_index++;
+                    scc_stack.push_back(edge.to);
+                    on_stack[edge.to] = 1;
+                    call_stack.push_back({edge.to, 0});
+                }
+                else if (on_stack[edge.to])
+                {
+                    lowlink[cell] = std::min(lowlink[cell], index[edge.to]);
+                }
+                continue;
+            }
+
+            // Every edge looked at, so cell is done
+            call_stack.pop_back();
+            if (!call_stack.empty())
+            {
+                int parent = call_stack.back().first;
+                lowlink[parent] = std::min(lowlink[parent], lowlink[cell]);
+            }
+
+            // Cell is the root of a component, pop it
+            if (lowlink[cell] == index[cell])
+            {
+                int member;
+                do
+                {
+                    member = scc_stack.back();
+                    scc_stack.pop_back();
+                    on_stack[member] = 0;
+                    component[member] = report.component_count;
+                } while (member != cell);
+
+                report.component_count++;
+            }
+        }
+    }
+
+    // Which components can still reach the finish
+    //--------------------------------------------------------------------------------------
+
+    // Tarjan numbers components in reverse topological order (successors first), so one pass over
+    // them in numbering order sees every successor before its predecessors
+    std::vector<std::vector<int>> members(report.component_count);
+    for (int cell : order)
+        members[component[cell]].push_back(cell);
+
+    std::vector<uint8_t> component_finishes(report.component_count, 0);
+    for (int comp = 0; comp < report.component_count; comp++)
+    {
+        for (int cell : members[comp])
+        {
+            for (int dir = 0; dir < 4; dir++)
+            {
+                const SlideGraph::Edge &edge = graph.edge(cell, (Direction)dir);
+
+                if (edge.blocked_by == GridVal_Finish || (isMoveEdge(edge, cell) && component_finishes[component[edge.to]]))
+                    component_finishes[comp] = 1;
+            }
+        }
+    }
+
+    report.finish_reachable = component_finishes[component[start]] != 0;
+
+    for (int comp = 0; comp < report.component_count; comp++)
+    {
+        if (component_finishes[comp])
+            continue;
+
+        report.softlocks.push_back(TrapRegion{graph.cellPos(members[comp].front()), (int)members[comp].size()});
+        report.softlock_cells += (int)members[comp].size();
+    }
+
+    // Checkpoints and damage
+    //--------------------------------------------------------------------------------------
+    std::vector<uint8_t> checkpoint_touched(graph.getCheckpointCount(), 0);
+
+    for (int cell : order)
+    {
+        bool can_move = false;
+        bool hits_damage = false;
+
+        for (int dir = 0; dir < 4; dir++)
+        {
+            const SlideGraph::Edge &edge = graph.edge(cell, (Direction)dir);
+
+            if (edge.checkpoint >= 0)
+                checkpoint_touched[edge.checkpoint] = 1;
+
+            if (edge.blocked_by == GridVal_Damage)
+                hits_damage = true;
+            else if (edge.to != cell || edge.blocked_by == GridVal_Finish)
+                can_move = true;
+        }
+
+        // Nowhere to go but into damage
+        if (hits_damage && !can_move)
+            report.death_traps.push_back(graph.cellPos(cell));
+    }
+
+    for (int cell = 0; cell < cell_count; cell++)
+    {
+        int id = graph.checkpointId(cell);
+        if (id >= 0 && !checkpoint_touched[id])
+        {
+            report.unreachable_checkpoints.push_back(graph.cellPos(cell));
+
+            // Only report each checkpoint once
+            checkpoint_touched[id] = 1;
+        }
+    }
+
+    return report;
+}
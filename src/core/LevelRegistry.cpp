@@ -0,0 +1,74 @@
+#include "core/LevelRegistry.hpp"
+
+#include <fstream>
+
+// Read the level list, returns false if the file can't be read or lists no levels
+bool LevelRegistry::load(const std::string &path)
+{
+    std::ifstream file(path);
+    if (!file)
+        return false;
+
+    // Levels are next to the list
+    std::string dir;
+    size_t slash = path.find_last_of("/\\");
+    if (slash != std::string::npos)
+        dir = path.substr(0, slash + 1);
+
+    levels.clear();
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        // Trim whitespace (and the \r of CRLF files)
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos)
+            continue;
+        size_t last = line.find_last_not_of(" \t\r");
+        line = line.substr(first, last - first + 1);
+
+        if (line[0] == '#')
+            continue;
+
+        add(line, dir);
+    }
+
+    return !levels.empty();
+}
+
+// Add a level by name (dir is prepended to its paths)
+void LevelRegistry::add(const std::string &name, const std::string &dir)
+{
+    levels.push_back({name, dir + name + ".ctl", dir + name + ".json"});
+}
+
+void LevelRegistry::clear()
+{
+    levels.clear();
+}
+
+size_t LevelRegistry::size() const
+{
+    return levels.size();
+}
+
+bool LevelRegistry::empty() const
+{
+    return levels.empty();
+}
+
+const LevelEntry &LevelRegistry::at(size_t index) const
+{
+    return levels[index];
+}
+
+// Index of the level called name, or -1
+int LevelRegistry::find(const std::string &name) const
+{
+    for (size_t i = 0; i < levels.size(); i++)
+    {
+        if (levels[i].name == name)
+            return (int)i;
+    }
+    return -1;
+}
@@ -0,0 +1,273 @@
+#include "core/Replay.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+// File magic and format version
+static const uint8_t replay_magic[4] = {'C', 'T', 'R', 'P'};
+static const uint8_t replay_version = 1;
+
+// Level hashing
+// ======================================================================================
+
+// FNV-1a
+static uint64_t hashBytes(uint64_t hash, const void *data, size_t size)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// Hash of everything about a level that affects the rules (grid size, contents and spawn)
+uint64_t hashLevel(const Level &level)
+{
+    const int32_t header[4] = {level.grid.width(), level.grid.height(), level.spawn_pos.x, level.spawn_pos.y};
+
+    uint64_t hash = 0xcbf29ce484222325ull;
+    hash = hashBytes(hash, header, sizeof(header));
+    hash = hashBytes(hash, level.grid.data(), level.grid.size());
+    return hash;
+}
+
+// Binary encoding
+// ======================================================================================
+
+// LEB128 varint
+static void writeVarint(std::vector<uint8_t> &out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(uint8_t(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(uint8_t(value));
+}
+
+static bool readVarint(const uint8_t *&data, const uint8_t *end, uint64_t &value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64 && data < end; shift += 7)
+    {
+        uint8_t byte = *data++;
+        value |= uint64_t(byte & 0x7f) << shift;
+
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+void encodeReplay(const Replay &replay, std::vector<uint8_t> &out)
+{
+    out.assign(replay_magic, replay_magic + 4);
+    out.push_back(replay_version);
+
+    for (int i = 0; i < 8; i++)
+        out.push_back(uint8_t(replay.level_hash >> (i * 8)));
+
+    // Inputs as tick deltas, then the end marker
+    uint32_t tick = 0;
+    for (const ReplayInput &input : replay.inputs)
+    {
+        writeVarint(out, (uint64_t(input.tick - tick) << 3) | input.input);
+        tick = input.tick;
+    }
+    writeVarint(out, (uint64_t(replay.end_tick - tick) << 3) | SimInput_None);
+}
+
+bool decodeReplay(const uint8_t *data, size_t size, Replay &replay)
+{
+    const uint8_t *end = data + size;
+
+    if (size < 13 || std::memcmp(data, replay_magic, 4) != 0 || data[4] != replay_version)
+        return false;
+    data += 5;
+
+    replay.level_hash = 0;
+    for (int i = 0; i < 8; i++)
+        replay.level_hash |= uint64_t(*data++) << (i * 8);
+
+    replay.inputs.clear();
+    uint64_t tick = 0;
+    while (true)
+    {
+        uint64_t value;
+        if (!readVarint(data, end, value))
+            return false;
+
+        tick += value >> 3;
+        SimInput input = SimInput(value & 7);
+
+        if (tick > UINT32_MAX || input > SimInput_Reset)
+            return false;
+
+        // End of the run
+        if (input == SimInput_None)
+        {
+            replay.end_tick = (uint32_t)tick;
+            return data == end;
+        }
+
+        replay.inputs.push_back(ReplayInput{(uint32_t)tick, input});
+    }
+}
+
+bool saveReplay(const std::string &path, const Replay &replay)
+{
+    std::vector<uint8_t> bytes;
+    encodeReplay(replay, bytes);
+
+    FILE *file = std::fopen(path.c_str(), "wb");
+    if (!file)
+        return false;
+
+    bool ok = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+bool loadReplay(const std::string &path, Replay &replay)
+{
+    FILE *file = std::fopen(path.c_str(), "rb");
+    if (!file)
+        return false;
+
+    std::vector<uint8_t> bytes;
+    uint8_t buffer[4096];
+    size_t count;
+    while ((count = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+        bytes.insert(bytes.end(), buffer, buffer + count);
+    std::fclose(file);
+
+    return decodeReplay(bytes.data(), bytes.size(), replay);
+}
+
+// Recording
+// ======================================================================================
+
+// Constructor
+ReplayRecorder::ReplayRecorder()
+{
+    replay = Replay{0, {}, 0};
+    recording = false;
+}
+
+// Start a new run on a level
+void ReplayRecorder::begin(uint64_t level_hash)
+{
+    replay.level_hash = level_hash;
+    replay.inputs.clear();
+    replay.end_tick = 0;
+    recording = true;
+}
+
+// Call once per simulation step with that step's input
+void ReplayRecorder::record(SimInput input)
+{
+    if (!recording)
+        return;
+
+    if (input != SimInput_None)
+        replay.inputs.push_back(ReplayInput{replay.end_tick, input});
+
+    replay.end_tick++;
+}
+
+// Stop recording, the replay ends after the last step recorded
+void ReplayRecorder::end()
+{
+    recording = false;
+}
+
+// Throw away the current run
+void ReplayRecorder::cancel()
+{
+    recording = false;
+    replay.inputs.clear();
+    replay.end_tick = 0;
+}
+
+bool ReplayRecorder::isRecording() const
+{
+    return recording;
+}
+
+const Replay &ReplayRecorder::getReplay() const
+{
+    return replay;
+}
+
+// Playback
+// ======================================================================================
+
+// Constructor
+ReplayPlayer::ReplayPlayer()
+{
+    replay = nullptr;
+    next_input = 0;
+    tick = 0;
+}
+
+// Start playing back replay from its first tick
+void ReplayPlayer::start(const Replay &replay)
+{
+    this->replay = &replay;
+    next_input = 0;
+    tick = 0;
+}
+
+// Real-time playback: the input for the next step
+SimInput ReplayPlayer::nextInput()
+{
+    if (isDone())
+        return SimInput_None;
+
+    SimInput input = SimInput_None;
+    if (next_input < replay->inputs.size() && replay->inputs[next_input].tick == tick)
+        input = replay->inputs[next_input++].input;
+
+    tick++;
+    return input;
+}
+
+// Has every step of the replay been played
+bool ReplayPlayer::isDone() const
+{
+    return !replay || tick >= replay->end_tick;
+}
+
+// Fast-forward: re-simulate a whole replay from the start of the level in one go
+PlaybackResult playReplay(Simulation &sim, uint64_t level_hash, const Replay &replay)
+{
+    PlaybackResult result = {false, false, false, 0, 0};
+
+    result.level_matches = replay.level_hash == level_hash;
+    if (!result.level_matches)
+        return result;
+
+    sim.reset();
+
+    uint8_t events = SimEvent_None;
+    uint32_t tick = 0;
+    for (const ReplayInput &input : replay.inputs)
+    {
+        // Inputs must be in order and inside the run
+        if (input.tick < tick || input.tick >= replay.end_tick)
+            return result;
+
+        // Nothing happens on the idle steps in between, apart from the timer
+        events |= sim.advance(input.tick - tick);
+        events |= sim.step(input.input);
+        tick = input.tick + 1;
+    }
+    events |= sim.advance(replay.end_tick - tick);
+
+    result.timed_out = (events & SimEvent_TimeUp) != 0;
+    result.finished = sim.isFinished();
+    result.time_ticks = sim.getTicks();
+    result.steps = replay.end_tick;
+    return result;
+}
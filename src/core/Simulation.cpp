@@ -0,0 +1,391 @@
+#include "core/Simulation.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+// Simulation Initialization
+// ==================================================
+
+// Constructor
+Simulation::Simulation()
+{
+    player_orient = Direction_Down;
+    player_pos = {-1, -1};
+
+    ticks = 0;
+    time_limit_ticks = UINT32_MAX;
+    finished = false;
+}
+
+// Start playing level, returns false (leaving the simulation as it was) if it has no spawn
+bool Simulation::load(const Level &level)
+{
+    if (!level.grid.inBounds(level.spawn_pos.x, level.spawn_pos.y))
+        return false;
+
+    object_map.copyFrom(level.grid);
+    dynamic_cells.clear();
+
+    // Place the player at spawn
+    player_orient = Direction_Down;
+    player_pos = level.spawn_pos;
+    object_map.at(player_pos.x, player_pos.y) = GridVal_Player;
+
+    // Set first checkpoint and level start state now
+    saveCheckpoint(level_start);
+    saveCheckpoint(checkpoint);
+
+    // Precompute every slide on the level
+    slide_table.build(&object_map);
+    checkInvariants();
+
+    ticks = 0;
+    finished = false;
+    return true;
+}
+
+// Back to the start of the level, with the timer at zero
+void Simulation::reset()
+{
+    // Reset map and checkpoint
+    restoreCheckpoint(level_start);
+    checkpoint = level_start;
+
+    ticks = 0;
+    finished = false;
+}
+
+// Checkpoints
+// ======================================================================================
+
+// Save the current mutable state into cp
+void Simulation::saveCheckpoint(Checkpoint &cp)
+{
+    cp.player_pos = player_pos;
+    cp.player_orient = player_orient;
+
+    // Reuses cp's storage, so this doesn't allocate once it has grown
+    cp.dynamic_cells = dynamic_cells;
+}
+
+// Return the mutable state to what was saved in cp
+void Simulation::restoreCheckpoint(const Checkpoint &cp)
+{
+    // Put back the level's own contents wherever things have changed since
+    for (CellDelta &cell : dynamic_cells)
+    {
+        object_map(cell.pos.x, cell.pos.y) = cell.static_val;
+        slide_table.invalidateCell(cell.pos);
+    }
+
+    // The player only ever moves through empty cells
+    object_map(player_pos.x, player_pos.y) = GridVal_Empty;
+
+    // Re-apply the checkpoint's changes
+    for (const CellDelta &cell : cp.dynamic_cells)
+    {
+        object_map(cell.pos.x, cell.pos.y) = cell.val;
+        slide_table.invalidateCell(cell.pos);
+    }
+    dynamic_cells = cp.dynamic_cells;
+
+    player_pos = cp.player_pos;
+    player_orient = cp.player_orient;
+    object_map(player_pos.x, player_pos.y) = GridVal_Player;
+
+    checkInvariants();
+}
+
+// Level edits
+// ======================================================================================
+
+// Change what the static level has in a cell, keeping the player, timer and checkpoints
+void Simulation::restampCell(Vector2i pos, GridVal val)
+{
+    if (!object_map.inBounds(pos.x, pos.y))
+        return;
+
+    // Dynamic cells (here and in saved states) keep what's there now, only what they return to changes
+    bool is_dynamic = false;
+    for (std::vector<CellDelta> *cells : {&dynamic_cells, &checkpoint.dynamic_cells, &level_start.dynamic_cells})
+    {
+        for (CellDelta &cell : *cells)
+        {
+            if (cell.pos.x == pos.x && cell.pos.y == pos.y)
+            {
+                cell.static_val = val;
+                if (cells == &dynamic_cells)
+                    is_dynamic = true;
+            }
+        }
+    }
+
+    // The player stays put, even if the edit puts something under them
+    bool is_player = pos.x == player_pos.x && pos.y == player_pos.y;
+
+    if (!is_dynamic && !is_player)
+        object_map(pos.x, pos.y) = val;
+
+    slide_table.invalidateCell(pos);
+}
+
+// Move the level's spawn (used on the next full reset)
+void Simulation::setSpawn(Vector2i pos)
+{
+    if (object_map.inBounds(pos.x, pos.y))
+        level_start.player_pos = pos;
+}
+
+// Stepping
+// ======================================================================================
+
+// Advance one tick
+uint8_t Simulation::step(SimInput input)
+{
+    // Nothing moves once the level is won
+    if (finished)
+        return SimEvent_None;
+
+    // If the time runs out
+    if (ticks >= time_limit_ticks)
+    {
+        reset();
+        return SimEvent_TimeUp;
+    }
+
+    uint8_t events = handleInput(input);
+
+    // The timer stops on the tick the finish is reached
+    if (!finished)
+        ticks++;
+
+    return events;
+}
+
+// Advance count ticks with no input
+uint8_t Simulation::advance(uint32_t count)
+{
+    uint8_t events = SimEvent_None;
+
+    while (count > 0 && !finished)
+    {
+        // The tick that finds the time already up resets instead of counting
+        if (ticks >= time_limit_ticks)
+        {
+            reset();
+            events |= SimEvent_TimeUp;
+            count--;
+            continue;
+        }
+
+        // Idle ticks only move the timer, so skip to the time limit at most
+        uint32_t skip = std::min(count, time_limit_ticks - ticks);
+        ticks += skip;
+        count -= skip;
+    }
+
+    return events;
+}
+
+// Apply one tick's input
+uint8_t Simulation::handleInput(SimInput input)
+{
+    // Set the desired movement direction
+    Direction desired_dir;
+    switch (input)
+    {
+    case SimInput_Up:
+        desired_dir = Direction_Up;
+        player_orient = Direction_Up;
+        break;
+    case SimInput_Down:
+        desired_dir = Direction_Down;
+        player_orient = Direction_Down;
+        break;
+    case SimInput_Left:
+        desired_dir = Direction_Left;
+        player_orient = Direction_Right;
+        break;
+    case SimInput_Right:
+        desired_dir = Direction_Right;
+        player_orient = Direction_Left;
+        break;
+
+    // Back to the last checkpoint
+    case SimInput_Reset:
+        restoreCheckpoint(checkpoint);
+        return SimEvent_Reset;
+
+    // If the player isn't moving, we're done
+    case SimInput_None:
+    default:
+        return SimEvent_None;
+    }
+
+    // Move
+    Vector2i pos = player_pos;
+    MoveInfo mov_info = infGridMove(pos, desired_dir);
+
+    uint8_t events = SimEvent_None;
+
+    // Handle what you were hit by
+    switch (mov_info.blocked_by)
+    {
+        // Hit a damage block
+    case GridVal_Damage:
+    {
+        restoreCheckpoint(checkpoint);
+        return SimEvent_Died;
+    }
+    break;
+
+        // Hit a checkpoint
+    case GridVal_CheckP:
+    {
+        saveCheckpoint(checkpoint);
+        events |= SimEvent_Checkpoint;
+    }
+    break;
+
+        // Hit the finish
+    case GridVal_Finish:
+    {
+        finished = true;
+        events |= SimEvent_Finished;
+    }
+    break;
+
+    default:
+        break;
+    }
+
+    // Did we actually move anywhere
+    if (pos.x != mov_info.final_pos.x || pos.y != mov_info.final_pos.y)
+        events |= SimEvent_Moved;
+
+    return events;
+}
+
+// Grid Handling
+// ======================================================================================
+
+// Moves an entity at pos by mov, then returns if the movement was successful (ie. not blocked)
+bool Simulation::gridMove(Vector2i pos, Vector2i mov)
+{
+    // Return false if value is out of range
+    if (!object_map.inBounds(pos.x + mov.x, pos.y + mov.y))
+    {
+        return false;
+    }
+    // Move from current position to destination if destination is empty, and return true
+    else if (object_map(pos.x + mov.x, pos.y + mov.y) == GridVal_Empty)
+    {
+        object_map(pos.x + mov.x, pos.y + mov.y) = object_map(pos.x, pos.y);
+        object_map(pos.x, pos.y) = GridVal_Empty;
+
+        // Keep the tracked player position in sync
+        if (pos.x == player_pos.x && pos.y == player_pos.y)
+            player_pos = {pos.x + mov.x, pos.y + mov.y};
+
+        return true;
+    }
+    // If destination is occupied, return false
+    else
+    {
+        return false;
+    }
+}
+
+// Move in a specified direction infinitely until blocked, returning the info of where it stopped and what it was blocked by
+MoveInfo Simulation::infGridMove(Vector2i pos, Direction dir)
+{
+    // Look up where the slide stops
+    MoveInfo mov_info = slide_table.query(pos, dir);
+
+    // Move there in one step
+    if (mov_info.final_pos.x != pos.x || mov_info.final_pos.y != pos.y)
+        gridMove(pos, {mov_info.final_pos.x - pos.x, mov_info.final_pos.y - pos.y});
+
+    // Return the final position of the moving block and what it hit
+    return mov_info;
+}
+
+// Check what type of entity is at the specified location
+GridVal Simulation::gridCheck(Vector2i pos) const
+{
+    // Return GridVal_SolidBlock if the position is out of range
+    if (!object_map.inBounds(pos.x, pos.y))
+    {
+        return GridVal_SolidBlock;
+    }
+    return (GridVal)object_map(pos.x, pos.y);
+}
+
+// Debug builds: assert the grid holds exactly one player, in the tracked cell
+void Simulation::checkInvariants() const
+{
+#ifndef NDEBUG
+    assert(gridCheck(player_pos) == GridVal_Player);
+    assert(std::count(object_map.data(), object_map.data() + object_map.size(), (uint8_t)GridVal_Player) == 1);
+#endif
+}
+
+// State
+// ======================================================================================
+
+// Returns which cell the player is in
+Vector2i Simulation::getPlayerPos() const
+{
+    // The full grid scan is in checkInvariants()
+    assert(gridCheck(player_pos) == GridVal_Player);
+
+    return player_pos;
+}
+
+Direction Simulation::getPlayerOrient() const
+{
+    return player_orient;
+}
+
+// How far up the level the player is
+float Simulation::getVertProgress() const
+{
+    return (float)player_pos.y / (float)object_map.height();
+}
+
+const GridBuffer<uint8_t> &Simulation::getObjectMap() const
+{
+    return object_map;
+}
+
+SlideTable &Simulation::getSlideTable()
+{
+    return slide_table;
+}
+
+uint32_t Simulation::getTicks() const
+{
+    return ticks;
+}
+
+// Elapsed game time in seconds
+float Simulation::getTime() const
+{
+    return (float)ticks / tick_rate;
+}
+
+void Simulation::setTimeLimit(float seconds)
+{
+    time_limit_ticks = (uint32_t)std::lround(seconds * tick_rate);
+}
+
+float Simulation::getTimeLimit() const
+{
+    return (float)time_limit_ticks / tick_rate;
+}
+
+bool Simulation::isFinished() const
+{
+    return finished;
+}
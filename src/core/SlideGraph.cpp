@@ -0,0 +1,92 @@
+#include "core/SlideGraph.hpp"
+
+#include "core/SlideTable.hpp"
+
+// Constructor
+SlideGraph::SlideGraph()
+{
+    w = 0;
+    h = 0;
+    checkpoint_count = 0;
+}
+
+// Build the graph for a level's static grid
+void SlideGraph::build(const Level &level)
+{
+    w = level.grid.width();
+    h = level.grid.height();
+    cells.assign(level.grid.data(), level.grid.data() + level.grid.size());
+
+    labelCheckpoints();
+
+    // The slide table already knows where every slide stops
+    SlideTable slide_table;
+    slide_table.build(&level.grid);
+
+    const Vector2i steps[4] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+
+    edges.resize((size_t)w * h * 4);
+    for (int y = 0; y < h; y++)
+    {
+        for (int x = 0; x < w; x++)
+        {
+            for (int dir = 0; dir < 4; dir++)
+            {
+                MoveInfo mov_info = slide_table.query({x, y}, (Direction)dir);
+
+                Edge &edge = edges[((size_t)y * w + x) * 4 + dir];
+                edge.to = cellIndex(mov_info.final_pos);
+                edge.blocked_by = mov_info.blocked_by;
+                edge.checkpoint = -1;
+
+                // The checkpoint is the cell just past where the slide stopped
+                if (mov_info.blocked_by == GridVal_CheckP)
+                {
+                    Vector2i hit = {mov_info.final_pos.x + steps[dir].x, mov_info.final_pos.y + steps[dir].y};
+                    edge.checkpoint = checkpoint_ids[cellIndex(hit)];
+                }
+            }
+        }
+    }
+}
+
+// Number the connected groups of checkpoint cells
+void SlideGraph::labelCheckpoints()
+{
+    checkpoint_ids.assign(cells.size(), -1);
+    checkpoint_count = 0;
+
+    std::vector<int> stack;
+    for (int start = 0; start < (int)cells.size(); start++)
+    {
+        if (cells[start] != GridVal_CheckP || checkpoint_ids[start] != -1)
+            continue;
+
+        // Flood fill this group of checkpoint cells
+        int32_t id = checkpoint_count++;
+        checkpoint_ids[start] = id;
+        stack.push_back(start);
+
+        while (!stack.empty())
+        {
+            int cell = stack.back();
+            stack.pop_back();
+
+            int x = cell % w;
+            int y = cell / w;
+            const int neighbours[4] = {x > 0 ? cell - 1 : -1,
+                                       x < w - 1 ? cell + 1 : -1,
+                                       y > 0 ? cell - w : -1,
+                                       y < h - 1 ? cell + w : -1};
+
+            for (int next : neighbours)
+            {
+                if (next != -1 && cells[next] == GridVal_CheckP && checkpoint_ids[next] == -1)
+                {
+                    checkpoint_ids[next] = id;
+                    stack.push_back(next);
+                }
+            }
+        }
+    }
+}
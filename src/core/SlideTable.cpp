@@ -0,0 +1,147 @@
+#include "core/SlideTable.hpp"
+
+// Constructor
+SlideTable::SlideTable()
+{
+    grid = nullptr;
+}
+
+// Does a cell stop a slide
+bool SlideTable::isBlocking(uint8_t val) const
+{
+    return val != GridVal_Empty && val != GridVal_Player;
+}
+
+// Build the table for every cell of grid
+void SlideTable::build(const GridBuffer<uint8_t> *grid)
+{
+    this->grid = grid;
+
+    for (auto &dir_entries : entries)
+        dir_entries.resize(grid->width(), grid->height(), Entry{0, GridVal_Empty, 0});
+
+    bitboards.build(*grid);
+
+    for (int y = 0; y < grid->height(); y++)
+        buildRow(y);
+
+    for (int x = 0; x < grid->width(); x++)
+        buildColumn(x);
+}
+
+// Fill in the left and right entries of a row
+void SlideTable::buildRow(int y)
+{
+    const int w = grid->width();
+
+    // Sweeping left to right, the nearest blocker on the left is the last one seen
+    // (the grid edge counts as a solid block)
+    int block = -1;
+    uint8_t block_val = GridVal_SolidBlock;
+    for (int x = 0; x < w; x++)
+    {
+        entries[Direction_Left](x, y) = Entry{uint16_t(block + 1), block_val, 0};
+
+        if (isBlocking((*grid)(x, y)))
+        {
+            block = x;
+            block_val = (*grid)(x, y);
+        }
+    }
+
+    // And the same right to left
+    block = w;
+    block_val = GridVal_SolidBlock;
+    for (int x = w - 1; x >= 0; x--)
+    {
+        entries[Direction_Right](x, y) = Entry{uint16_t(block - 1), block_val, 0};
+
+        if (isBlocking((*grid)(x, y)))
+        {
+            block = x;
+            block_val = (*grid)(x, y);
+        }
+    }
+}
+
+// Fill in the up and down entries of a column
+void SlideTable::buildColumn(int x)
+{
+    const int h = grid->height();
+
+    int block = -1;
+    uint8_t block_val = GridVal_SolidBlock;
+    for (int y = 0; y < h; y++)
+    {
+        entries[Direction_Up](x, y) = Entry{uint16_t(block + 1), block_val, 0};
+
+        if (isBlocking((*grid)(x, y)))
+        {
+            block = y;
+            block_val = (*grid)(x, y);
+        }
+    }
+
+    block = h;
+    block_val = GridVal_SolidBlock;
+    for (int y = h - 1; y >= 0; y--)
+    {
+        entries[Direction_Down](x, y) = Entry{uint16_t(block - 1), block_val, 0};
+
+        if (isBlocking((*grid)(x, y)))
+        {
+            block = y;
+            block_val = (*grid)(x, y);
+        }
+    }
+}
+
+// Recompute a single entry
+SlideTable::Entry SlideTable::computeEntry(Vector2i pos, Direction dir) const
+{
+    MoveInfo mov_info = bitboards.slide(pos, dir);
+
+    uint16_t stop = uint16_t(dir == Direction_Left || dir == Direction_Right ? mov_info.final_pos.x : mov_info.final_pos.y);
+    return Entry{stop, mov_info.blocked_by, 0};
+}
+
+// Where a slide from pos in dir stops, and what it was blocked by
+MoveInfo SlideTable::query(Vector2i pos, Direction dir)
+{
+    Entry &entry = entries[dir](pos.x, pos.y);
+
+    if (entry.dirty)
+        entry = computeEntry(pos, dir);
+
+    // Stop is stored along the axis of movement
+    if (dir == Direction_Left || dir == Direction_Right)
+        return MoveInfo{{entry.stop, pos.y}, (GridVal)entry.blocked_by};
+    else
+        return MoveInfo{{pos.x, entry.stop}, (GridVal)entry.blocked_by};
+}
+
+// Mark the entries whose slide could pass through pos as stale
+void SlideTable::invalidateCell(Vector2i pos)
+{
+    bitboards.setCell(pos, (*grid)(pos.x, pos.y));
+
+    // Horizontal slides along the row
+    for (int x = 0; x < grid->width(); x++)
+    {
+        entries[Direction_Left](x, pos.y).dirty = 1;
+        entries[Direction_Right](x, pos.y).dirty = 1;
+    }
+
+    // Vertical slides along the column
+    for (int y = 0; y < grid->height(); y++)
+    {
+        entries[Direction_Up](pos.x, y).dirty = 1;
+        entries[Direction_Down](pos.x, y).dirty = 1;
+    }
+}
+
+// Bit-packed layers of the grid
+const GridBitboards &SlideTable::getBitboards() const
+{
+    return bitboards;
+}
@@ -0,0 +1,148 @@
+#include "core/Solver.hpp"
+
+#include <algorithm>
+
+// Largest search (cells * checkpoint combinations) the solver will attempt
+static const size_t max_states = (size_t)1 << 28;
+
+// Input that slides in a direction
+static SimInput directionInput(Direction dir)
+{
+    switch (dir)
+    {
+    case Direction_Left:
+        return SimInput_Left;
+    case Direction_Right:
+        return SimInput_Right;
+    case Direction_Up:
+        return SimInput_Up;
+    case Direction_Down:
+    default:
+        return SimInput_Down;
+    }
+}
+
+// Find the minimal number of slides from spawn to the finish
+Solution solveLevel(const SlideGraph &graph, Vector2i spawn, const SolverOptions &options)
+{
+    Solution solution = {false, "", {}, {}, 0, 0.f, 0, 0};
+
+    if (spawn.x < 0 || spawn.y < 0 || spawn.x >= graph.width() || spawn.y >= graph.height())
+    {
+        solution.message = "level has no spawn";
+        return solution;
+    }
+
+    // Search state is (checkpoints touched, cell), or just the cell if checkpoints don't matter
+    const size_t cell_count = (size_t)graph.cellCount();
+    const int checkpoint_count = options.visit_all_checkpoints ? graph.getCheckpointCount() : 0;
+
+    if (checkpoint_count > 24 || (cell_count << checkpoint_count) > max_states)
+    {
+        solution.message = checkpoint_count > 0 ? "too many checkpoints to require visiting them all" : "level is too large to solve";
+        return solution;
+    }
+
+    const uint32_t all_checkpoints = (uint32_t)((1ull << checkpoint_count) - 1);
+    const size_t state_count = cell_count << checkpoint_count;
+
+    // How each state was first reached (-1 = not yet)
+    std::vector<int32_t> parent(state_count, -1);
+    std::vector<uint8_t> parent_dir(state_count, 0);
+
+    std::vector<uint32_t> frontier;
+    std::vector<uint32_t> next_frontier;
+
+    const uint32_t start = (uint32_t)graph.cellIndex(spawn);
+    parent[start] = (int32_t)start;
+    frontier.push_back(start);
+
+    // State that reached the finish, and the slide that did it
+    int64_t goal_state = -1;
+    Direction goal_dir = Direction_Down;
+
+    // Breadth-first, one layer of the search per move
+    while (!frontier.empty() && goal_state == -1)
+    {
+        next_frontier.clear();
+
+        for (uint32_t state : frontier)
+        {
+            solution.states_explored++;
+
+            const int cell = (int)(state % cell_count);
+            const uint32_t visited = (uint32_t)(state / cell_count);
+
+            for (int dir = 0; dir < 4 && goal_state == -1; dir++)
+            {
+                const SlideGraph::Edge &edge = graph.edge(cell, (Direction)dir);
+
+                // Dying sends the player back to a state they've already been in
+                if (edge.blocked_by == GridVal_Damage)
+                    continue;
+
+                uint32_t next_visited = visited;
+                if (edge.checkpoint >= 0 && edge.checkpoint < checkpoint_count)
+                    next_visited |= 1u << edge.checkpoint;
+
+                // Reached the finish (with every checkpoint, if that's required)
+                if (edge.blocked_by == GridVal_Finish)
+                {
+                    if (next_visited == all_checkpoints)
+                    {
+                        goal_state = state;
+                        goal_dir = (Direction)dir;
+                    }
+
+                    // The run ends on touching the finish either way
+                    continue;
+                }
+
+                const uint32_t next = (uint32_t)(next_visited * cell_count + edge.to);
+                if (parent[next] != -1)
+                    continue;
+
+                parent[next] = (int32_t)state;
+                parent_dir[next] = (uint8_t)dir;
+                next_frontier.push_back(next);
+            }
+        }
+
+        frontier.swap(next_frontier);
+    }
+
+    if (goal_state == -1)
+    {
+        solution.message = "finish is unreachable from spawn";
+        return solution;
+    }
+
+    // Walk back from the finish to the spawn
+    std::vector<Direction> dirs = {goal_dir};
+    for (uint32_t state = (uint32_t)goal_state; state != start; state = (uint32_t)parent[state])
+        dirs.push_back((Direction)parent_dir[state]);
+    std::reverse(dirs.begin(), dirs.end());
+
+    // Replay the route through the graph for the positions and checkpoints touched
+    std::vector<bool> touched(graph.getCheckpointCount(), false);
+    int cell = (int)start;
+    for (Direction dir : dirs)
+    {
+        const SlideGraph::Edge &edge = graph.edge(cell, dir);
+        if (edge.checkpoint >= 0 && !touched[edge.checkpoint])
+        {
+            touched[edge.checkpoint] = true;
+            solution.checkpoints_visited++;
+        }
+
+        cell = edge.to;
+        solution.inputs.push_back(directionInput(dir));
+        solution.path.push_back(graph.cellPos(cell));
+    }
+
+    solution.solved = true;
+    solution.moves = (uint32_t)dirs.size();
+    solution.par_time = solution.moves * options.seconds_per_move;
+
+    return solution;
+}
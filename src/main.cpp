@@ -8,10 +8,6 @@
 #define RAYGUI_IMPLEMENTATION
 #include "raygui.h"
 
-// Tiled loader
-#define CUTE_TILED_IMPLEMENTATION
-#include "cute/cute_tiled.h"
-
 // Collision
 #define CUTE_C2_IMPLEMENTATION
 #include "cute/cute_c2.hpp"
@@ -61,11 +57,17 @@ int main(int argc, char const *argv[])
     // Initialize the main App
     main_app = std::make_unique<App>(target, Vector2{(float)screen_w_const, (float)screen_h_const});
 
+#ifdef __EMSCRIPTEN__
     // This function is deprecated but its replacement doesn't produce the same result
     emscripten_set_canvas_size(1, 1);
 
     // Set the emscripten main loop
     emscripten_set_main_loop(updateAndDraw, 0, 1);
+#else
+    // Native main loop
+    while (!WindowShouldClose())
+        updateAndDraw();
+#endif
 
     // De-Initialization
     UnloadRenderTexture(target);
@@ -85,12 +87,18 @@ void transformMouseInput()
 
 void calcTexDest()
 {
+#ifdef __EMSCRIPTEN__
     // Determine HTML app window size and set raylib render window to this value
     double temp_w, temp_h;
     EMSCRIPTEN_RESULT res = emscripten_get_element_css_size("#canvas", &temp_w, &temp_h);
     screen_w = (int)temp_w;
     screen_h = (int)temp_h;
     SetWindowSize(screen_w, screen_h);
+#else
+    // Natively the window itself is the canvas
+    screen_w = GetScreenWidth();
+    screen_h = GetScreenHeight();
+#endif
 
     // Determine if screen size will be limited by width or height (ie. letterboxing)
     float ratio_x = (float)screen_w / (float)screen_w_const;
@@ -120,6 +128,9 @@ void updateAndDraw()
     // Draw all application to the texture
     main_app->update();
 
+    // The app re-creates its target when the quality tier changes its resolution
+    target = main_app->getTarget();
+
     // Draw the transformed app render texture to the window
     // Start drawing and clear tthe background
     BeginDrawing();
@@ -1,7 +1,20 @@
 #include "raylib_extension.hpp"
+#include "main.hpp"
 
 // Put any random small function/class implementations here
 
+static bool shadows_enabled = true;
+
+void SetShadowsEnabled(bool enabled)
+{
+    shadows_enabled = enabled;
+}
+
+bool AreShadowsEnabled()
+{
+    return shadows_enabled;
+}
+
 void SetGuiTextProps(TextProps props)
 {
     GuiSetFont(props.font);
@@ -27,6 +40,13 @@ TextProps GetGuiTextProps()
 
 void DrawGuiLabelShadow(Rectangle rect, std::string str, Vector2 offset, Color shadow_color)
 {
+    if (!shadows_enabled)
+    {
+        GuiLabel(rect, str.c_str());
+        CountDraw(GuiGetFont().texture.id);
+        return;
+    }
+
     // Get current text properties so we can revert
     TextProps current_props = GetGuiTextProps();
 
@@ -37,14 +57,312 @@ void DrawGuiLabelShadow(Rectangle rect, std::string str, Vector2 offset, Color s
     // Draw set text on top of shadow
     SetGuiTextProps(current_props);
     GuiLabel(rect, str.c_str());
+
+    CountDraw(current_props.font.texture.id);
+    CountDraw(current_props.font.texture.id);
 }
 
 void DrawShadowedTexture(ShadowedTextureProps props)
 {
+    if (!shadows_enabled)
+    {
+        DrawTexturePro(props.tex, props.src, props.dest, props.origin, props.rot, props.tint);
+        CountDraw(props.tex.id);
+        return;
+    }
+
     Rectangle shadow_dest = props.dest;
     shadow_dest.x += props.shadow_offset.x;
     shadow_dest.y += props.shadow_offset.y;
 
     DrawTexturePro(props.tex, props.src, shadow_dest, props.origin, props.rot, props.shadow_color);
     DrawTexturePro(props.tex, props.src, props.dest, props.origin, props.rot, props.tint);
-}
\ No newline at end of file
+
+    CountDraw(props.tex.id);
+    CountDraw(props.tex.id);
+}
+
+// Draw call counting
+// ======================================================================================
+
+static DrawStats draw_stats = {};
+
+// Texture of the batch being built, 0 if the next draw starts a new one
+static unsigned int batch_texture_id = 0;
+
+void ResetDrawStats()
+{
+    draw_stats = {};
+    batch_texture_id = 0;
+}
+
+void CountDraw(unsigned int texture_id)
+{
+    draw_stats.draws++;
+
+    if (texture_id != batch_texture_id)
+    {
+        draw_stats.batches++;
+        batch_texture_id = texture_id;
+    }
+}
+
+void CountBatchBreak()
+{
+    batch_texture_id = 0;
+}
+
+const DrawStats &GetDrawStats()
+{
+    return draw_stats;
+}
+
+// Cooked assets
+// ======================================================================================
+
+// Same path with a different extension
+static std::string CookedPath(const char *path, const char *extension)
+{
+    return std::filesystem::path(path).replace_extension(extension).string();
+}
+
+Font LoadGameFont(const char *ttf_path, int size, int glyph_count)
+{
+    std::string cooked_path = CookedPath(ttf_path, ".ctf");
+    if (FileExists(cooked_path.c_str()))
+    {
+        int file_size = 0;
+        unsigned char *data = LoadFileData(cooked_path.c_str(), &file_size);
+
+        CookedFontHeader header;
+        if (data && file_size >= (int)sizeof(header))
+        {
+            std::memcpy(&header, data, sizeof(header));
+
+            bool valid = std::memcmp(header.magic, cooked_font_magic, 4) == 0 &&
+                         header.version == cooked_asset_version &&
+                         header.base_size == size && header.glyph_count == glyph_count &&
+                         header.glyph_offset + (size_t)header.glyph_count * sizeof(CookedGlyph) <= (size_t)file_size &&
+                         header.atlas_offset + (size_t)header.atlas_size <= (size_t)file_size;
+
+            if (valid)
+            {
+                Font font = {0};
+                font.baseSize = header.base_size;
+                font.glyphCount = header.glyph_count;
+                font.glyphPadding = header.glyph_padding;
+
+                // Only the atlas PNG needs decoding, the glyphs are already rasterized
+                Image atlas = LoadImageFromMemory(".png", data + header.atlas_offset, (int)header.atlas_size);
+                font.texture = LoadTextureFromImage(atlas);
+                UnloadImage(atlas);
+
+                // UnloadFont() frees these with raylib's allocator
+                font.recs = (Rectangle *)MemAlloc(font.glyphCount * sizeof(Rectangle));
+                font.glyphs = (GlyphInfo *)MemAlloc(font.glyphCount * sizeof(GlyphInfo));
+
+                for (int i = 0; i < font.glyphCount; i++)
+                {
+                    CookedGlyph glyph;
+                    std::memcpy(&glyph, data + header.glyph_offset + i * sizeof(CookedGlyph), sizeof(glyph));
+
+                    font.recs[i] = Rectangle{glyph.rec_x, glyph.rec_y, glyph.rec_w, glyph.rec_h};
+                    font.glyphs[i].value = glyph.value;
+                    font.glyphs[i].offsetX = glyph.offset_x;
+                    font.glyphs[i].offsetY = glyph.offset_y;
+                    font.glyphs[i].advanceX = glyph.advance_x;
+                }
+
+                UnloadFileData(data);
+                return font;
+            }
+        }
+
+        UnloadFileData(data);
+        TraceLog(LOG_WARNING, "COOKED: %s is not a valid cooked font for size %d", cooked_path.c_str(), size);
+    }
+
+    return LoadFontEx(ttf_path, size, 0, glyph_count);
+}
+
+Sound LoadGameSound(const char *wav_path)
+{
+    // raylib reads QOA itself
+    std::string cooked_path = CookedPath(wav_path, ".qoa");
+    if (FileExists(cooked_path.c_str()))
+        return LoadSound(cooked_path.c_str());
+
+    return LoadSound(wav_path);
+}
+
+// Sprite atlas
+// ======================================================================================
+
+// Use the atlas' white sprite for shapes (inset a pixel so filtering never reaches the padding)
+static void UseAtlasForShapes(const SpriteAtlas &atlas)
+{
+    Rectangle white;
+    if (FindAtlasSprite(atlas, atlas_white_sprite, &white))
+        SetShapesTexture(atlas.tex, Rectangle{white.x + 1, white.y + 1, white.width - 2, white.height - 2});
+}
+
+// Read a cooked atlas, returns false if there isn't a valid one
+static bool LoadCookedAtlas(const char *cooked_path, SpriteAtlas &atlas)
+{
+    if (!FileExists(cooked_path))
+        return false;
+
+    int size = 0;
+    unsigned char *data = LoadFileData(cooked_path, &size);
+
+    CookedAtlasHeader header;
+    if (data && size >= (int)sizeof(header))
+    {
+        std::memcpy(&header, data, sizeof(header));
+
+        bool valid = std::memcmp(header.magic, cooked_atlas_magic, 4) == 0 &&
+                     header.version == cooked_asset_version &&
+                     header.sprites_offset + (size_t)header.sprite_count * sizeof(CookedAtlasSprite) <= (size_t)size &&
+                     (size_t)header.pixels_offset + header.pixels_size <= (size_t)size;
+
+        Image img = {};
+        if (valid)
+        {
+            img = LoadImageFromMemory(".qoi", data + header.pixels_offset, (int)header.pixels_size);
+            valid = img.data && img.width == (int)header.width && img.height == (int)header.height &&
+                    img.format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+        }
+
+        if (valid)
+        {
+            for (uint32_t i = 0; i < header.sprite_count; i++)
+            {
+                CookedAtlasSprite sprite;
+                std::memcpy(&sprite, data + header.sprites_offset + i * sizeof(CookedAtlasSprite), sizeof(sprite));
+                sprite.name[sizeof(sprite.name) - 1] = '\0';
+
+                atlas.rects[sprite.name] = Rectangle{(float)sprite.x, (float)sprite.y, (float)sprite.w, (float)sprite.h};
+            }
+
+            atlas.tex = LoadTextureFromImage(img);
+
+            UnloadImage(img);
+            UnloadFileData(data);
+            return true;
+        }
+
+        UnloadImage(img);
+    }
+
+    UnloadFileData(data);
+    TraceLog(LOG_WARNING, "COOKED: %s is not a valid cooked sprite atlas", cooked_path);
+    return false;
+}
+
+// Pack the raw images the same way the cooker does
+static bool PackAtlas(const std::vector<std::string> &image_paths, SpriteAtlas &atlas)
+{
+    std::vector<Image> images;
+    std::vector<std::string> names;
+    std::vector<PackedRect> rects;
+
+    for (const std::string &path : image_paths)
+    {
+        Image img = LoadImage(path.c_str());
+        if (!img.data)
+            continue;
+
+        ImageFormat(&img, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+        images.push_back(img);
+        names.push_back(AtlasSpriteName(path));
+        rects.push_back({0, 0, img.width, img.height});
+    }
+
+    images.push_back(GenImageColor(atlas_white_size, atlas_white_size, WHITE));
+    names.push_back(atlas_white_sprite);
+    rects.push_back({0, 0, atlas_white_size, atlas_white_size});
+
+    int32_t atlas_w, atlas_h;
+    bool packed = packAtlas(rects, atlas_padding, atlas_max_size, atlas_w, atlas_h);
+
+    if (packed)
+    {
+        std::vector<uint8_t> pixels((size_t)atlas_w * atlas_h * 4, 0);
+        for (size_t i = 0; i < images.size(); i++)
+        {
+            const PackedRect &rect = rects[i];
+            for (int32_t row = 0; row < rect.h; row++)
+                std::memcpy(&pixels[((size_t)(rect.y + row) * atlas_w + rect.x) * 4],
+                            (uint8_t *)images[i].data + (size_t)row * rect.w * 4,
+                            (size_t)rect.w * 4);
+
+            atlas.rects[names[i]] = Rectangle{(float)rect.x, (float)rect.y, (float)rect.w, (float)rect.h};
+        }
+
+        Image img = {pixels.data(), atlas_w, atlas_h, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8};
+        atlas.tex = LoadTextureFromImage(img);
+    }
+
+    for (Image &img : images)
+        UnloadImage(img);
+
+    return packed;
+}
+
+bool LoadSpriteAtlas(const char *cooked_path, const std::vector<std::string> &image_paths, SpriteAtlas &atlas)
+{
+    atlas.tex = {};
+    atlas.rects.clear();
+
+    if (!LoadCookedAtlas(cooked_path, atlas))
+    {
+        atlas.rects.clear();
+        TraceLog(LOG_INFO, "COOKED: No sprite atlas at %s, packing %d images", cooked_path, (int)image_paths.size());
+
+        if (!PackAtlas(image_paths, atlas))
+        {
+            TraceLog(LOG_ERROR, "COOKED: Sprites don't fit in a %dx%d atlas", atlas_max_size, atlas_max_size);
+            return false;
+        }
+    }
+
+    // Pixel art, sampled exactly
+    SetTextureFilter(atlas.tex, TEXTURE_FILTER_POINT);
+
+    UseAtlasForShapes(atlas);
+    return true;
+}
+
+void UnloadSpriteAtlas(SpriteAtlas &atlas)
+{
+    // Back to raylib's own shapes texture
+    SetShapesTexture(Texture2D{0}, Rectangle{0, 0, 0, 0});
+
+    UnloadTexture(atlas.tex);
+    atlas.tex = {};
+    atlas.rects.clear();
+}
+
+std::string AtlasSpriteName(const std::string &image_path)
+{
+    return std::filesystem::path(image_path).stem().string();
+}
+
+bool FindAtlasSprite(const SpriteAtlas &atlas, const std::string &name, Rectangle *rect)
+{
+    auto it = atlas.rects.find(name);
+    if (it == atlas.rects.end())
+        return false;
+
+    *rect = it->second;
+    return true;
+}
+
+Rectangle GetAtlasRect(const SpriteAtlas &atlas, const std::string &name, Rectangle src)
+{
+    Rectangle sprite;
+    if (!FindAtlasSprite(atlas, name, &sprite))
+        return Rectangle{0, 0, 0, 0};
+
+    return Rectangle{sprite.x + src.x, sprite.y + src.y, src.width, src.height};
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+// Minimal work-stealing thread pool for the command-line tools
+//
+// Tasks are numbered 0..count-1 and dealt round-robin onto one deque per worker. A worker takes from
+// the back of its own deque and, once that's empty, steals from the front of the others, so a worker
+// stuck with a few slow tasks gets helped instead of holding up the whole batch.
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkStealingPool
+{
+private:
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    // Take a task from our own deque, or steal one, returns false once there's nothing left anywhere
+    bool takeTask(size_t self, size_t &task)
+    {
+        {
+            Worker &own = *workers[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty())
+            {
+                task = own.tasks.back();
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+
+        // Tasks are only ever dealt up front, so one empty sweep means everything has been claimed
+        for (size_t i = 1; i < workers.size(); i++)
+        {
+            Worker &victim = *workers[(self + i) % workers.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty())
+            {
+                task = victim.tasks.front();
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+public:
+    explicit WorkStealingPool(unsigned thread_count)
+    {
+        for (unsigned i = 0; i < std::max(1u, thread_count); i++)
+            workers.push_back(std::make_unique<Worker>());
+    }
+
+    size_t size() const { return workers.size(); }
+
+    // Run fn(worker, task) for every task in [0, count), returning once all are done
+    template <typename Fn>
+    void run(size_t count, Fn fn)
+    {
+        for (size_t task = 0; task < count; task++)
+            workers[task % workers.size()]->tasks.push_back(task);
+
+        std::vector<std::thread> threads;
+        for (size_t self = 0; self < workers.size(); self++)
+        {
+            threads.emplace_back([this, self, &fn]()
+                                 {
+                                     size_t task;
+                                     while (takeTask(self, task))
+                                         fn(self, task); //
+                                 });
+        }
+
+        for (std::thread &thread : threads)
+            thread.join();
+    }
+};
@@ -0,0 +1,443 @@
+// Asset cooker
+//
+// Converts source assets into the forms the game loads fastest. Run by the cook_assets CMake target
+// for every asset, and only re-run when an asset (or this tool) changes.
+//
+// Usage:
+//   cattower_cook level   <map.json> <out.ctl>                   Tiled level -> cooked level (core/CookedLevel.hpp)
+//   cattower_cook atlas   <out.cta> <image.png>...               images -> one packed sprite atlas (core/CookedAssets.hpp)
+//   cattower_cook font    <font.ttf> <out.ctf> <size> <glyphs>   TrueType -> baked glyph atlas (core/CookedAssets.hpp)
+//   cattower_cook sound   <sound.wav> <out.qoa>                  WAV -> QOA (about 1/5 the size, loaded by raylib directly)
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "core/CookedLevel.hpp"
+#include "core/CookedAssets.hpp"
+#include "core/AtlasPacker.hpp"
+
+// Single-header libraries raylib ships in src/external
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+
+#define STB_TRUETYPE_IMPLEMENTATION
+#include "stb_truetype.h"
+
+#define DR_WAV_IMPLEMENTATION
+#include "dr_wav.h"
+
+#define QOA_IMPLEMENTATION
+#include "qoa.h"
+
+#define QOI_IMPLEMENTATION
+#include "qoi.h"
+
+// Same glyph padding raylib's LoadFontEx() uses (FONT_TTF_DEFAULT_CHARS_PADDING)
+static const int font_glyph_padding = 4;
+
+// Widest font atlas the cooker will make
+static const int font_atlas_width = 1024;
+
+// File helpers
+// ======================================================================================
+
+static bool readFile(const char *path, std::vector<uint8_t> &bytes)
+{
+    FILE *file = std::fopen(path, "rb");
+    if (!file)
+        return false;
+
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+
+    bytes.resize(size > 0 ? (size_t)size : 0);
+    bool ok = std::fread(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    std::fclose(file);
+    return ok;
+}
+
+static bool writeFile(const char *path, const std::vector<uint8_t> &bytes)
+{
+    FILE *file = std::fopen(path, "wb");
+    if (!file)
+        return false;
+
+    bool ok = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+// Append a plain struct to a byte buffer
+template <typename T>
+static void appendStruct(std::vector<uint8_t> &out, const T &value)
+{
+    const uint8_t *bytes = (const uint8_t *)&value;
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+// Levels
+// ======================================================================================
+
+static int cookLevelAsset(const char *in, const char *out)
+{
+    std::vector<uint8_t> bytes;
+    std::string error;
+    if (!cookLevelFile(in, bytes, error))
+    {
+        std::fprintf(stderr, "%s: %s\n", in, error.c_str());
+        return 1;
+    }
+
+    if (!writeFile(out, bytes))
+    {
+        std::fprintf(stderr, "could not write %s\n", out);
+        return 1;
+    }
+
+    std::printf("%s -> %s (%zu bytes)\n", in, out, bytes.size());
+    return 0;
+}
+
+// Sprite atlas
+// ======================================================================================
+
+// File name without directories or extension
+static std::string spriteName(const char *path)
+{
+    std::string name = path;
+
+    size_t slash = name.find_last_of("/\\");
+    if (slash != std::string::npos)
+        name = name.substr(slash + 1);
+
+    size_t dot = name.find_last_of('.');
+    if (dot != std::string::npos)
+        name = name.substr(0, dot);
+
+    return name;
+}
+
+// Encode RGBA8 pixels as a QOI image
+static bool encodeQoi(const uint8_t *pixels, int w, int h, std::vector<uint8_t> &out)
+{
+    qoi_desc desc = {(unsigned int)w, (unsigned int)h, 4, QOI_SRGB};
+
+    int size = 0;
+    void *encoded = qoi_encode(pixels, &desc, &size);
+    if (!encoded)
+        return false;
+
+    out.assign((uint8_t *)encoded, (uint8_t *)encoded + size);
+    QOI_FREE(encoded);
+    return true;
+}
+
+static int cookAtlasAsset(const char *out, const char *const *images, int image_count)
+{
+    struct Sprite
+    {
+        std::string name;
+        std::vector<uint8_t> pixels;
+    };
+
+    std::vector<Sprite> sprites;
+    std::vector<PackedRect> rects;
+
+    for (int i = 0; i < image_count; i++)
+    {
+        int w, h, channels;
+        stbi_uc *pixels = stbi_load(images[i], &w, &h, &channels, 4);
+        if (!pixels)
+        {
+            std::fprintf(stderr, "%s: %s\n", images[i], stbi_failure_reason());
+            return 1;
+        }
+
+        Sprite sprite;
+        sprite.name = spriteName(images[i]);
+        sprite.pixels.assign(pixels, pixels + (size_t)w * h * 4);
+        stbi_image_free(pixels);
+
+        if (sprite.name.size() >= sizeof(CookedAtlasSprite::name))
+        {
+            std::fprintf(stderr, "%s: sprite name is too long\n", images[i]);
+            return 1;
+        }
+
+        sprites.push_back(sprite);
+        rects.push_back({0, 0, w, h});
+    }
+
+    // Shapes are drawn with a white sprite, so they batch with everything else
+    sprites.push_back({atlas_white_sprite, std::vector<uint8_t>(atlas_white_size * atlas_white_size * 4, 255)});
+    rects.push_back({0, 0, atlas_white_size, atlas_white_size});
+
+    int32_t atlas_w, atlas_h;
+    if (!packAtlas(rects, atlas_padding, atlas_max_size, atlas_w, atlas_h))
+    {
+        std::fprintf(stderr, "%s: sprites don't fit in a %dx%d atlas\n", out, atlas_max_size, atlas_max_size);
+        return 1;
+    }
+
+    // Copy each sprite into place, row by row
+    std::vector<uint8_t> atlas_pixels((size_t)atlas_w * atlas_h * 4, 0);
+    for (size_t i = 0; i < sprites.size(); i++)
+    {
+        const PackedRect &rect = rects[i];
+        for (int32_t row = 0; row < rect.h; row++)
+            std::memcpy(&atlas_pixels[((size_t)(rect.y + row) * atlas_w + rect.x) * 4],
+                        &sprites[i].pixels[(size_t)row * rect.w * 4],
+                        (size_t)rect.w * 4);
+    }
+
+    std::vector<uint8_t> qoi;
+    if (!encodeQoi(atlas_pixels.data(), atlas_w, atlas_h, qoi))
+    {
+        std::fprintf(stderr, "%s: could not encode\n", out);
+        return 1;
+    }
+
+    CookedAtlasHeader header = {};
+    std::memcpy(header.magic, cooked_atlas_magic, 4);
+    header.version = cooked_asset_version;
+    header.width = (uint32_t)atlas_w;
+    header.height = (uint32_t)atlas_h;
+    header.sprite_count = (uint32_t)sprites.size();
+    header.sprites_offset = sizeof(CookedAtlasHeader);
+    header.pixels_offset = header.sprites_offset + header.sprite_count * sizeof(CookedAtlasSprite);
+    header.pixels_size = (uint32_t)qoi.size();
+
+    std::vector<uint8_t> bytes;
+    appendStruct(bytes, header);
+    for (size_t i = 0; i < sprites.size(); i++)
+    {
+        CookedAtlasSprite sprite = {};
+        std::strncpy(sprite.name, sprites[i].name.c_str(), sizeof(sprite.name) - 1);
+        sprite.x = rects[i].x;
+        sprite.y = rects[i].y;
+        sprite.w = rects[i].w;
+        sprite.h = rects[i].h;
+        appendStruct(bytes, sprite);
+    }
+    bytes.insert(bytes.end(), qoi.begin(), qoi.end());
+
+    if (!writeFile(out, bytes))
+    {
+        std::fprintf(stderr, "could not write %s\n", out);
+        return 1;
+    }
+
+    std::printf("%d images -> %s (%dx%d, %zu bytes)\n", image_count, out, atlas_w, atlas_h, bytes.size());
+    return 0;
+}
+
+// Fonts
+// ======================================================================================
+
+static void writeToVector(void *context, void *data, int size)
+{
+    std::vector<uint8_t> *out = (std::vector<uint8_t> *)context;
+    out->insert(out->end(), (uint8_t *)data, (uint8_t *)data + size);
+}
+
+// Rasterize glyphs 32..32+glyph_count-1 the way raylib's LoadFontData() does and pack them into an atlas
+static int cookFontAsset(const char *in, const char *out, int font_size, int glyph_count)
+{
+    std::vector<uint8_t> ttf;
+    stbtt_fontinfo font_info;
+    if (!readFile(in, ttf) || !stbtt_InitFont(&font_info, ttf.data(), stbtt_GetFontOffsetForIndex(ttf.data(), 0)))
+    {
+        std::fprintf(stderr, "%s: not a TrueType font\n", in);
+        return 1;
+    }
+
+    const float scale = stbtt_ScaleForPixelHeight(&font_info, (float)font_size);
+
+    int ascent, descent, line_gap;
+    stbtt_GetFontVMetrics(&font_info, &ascent, &descent, &line_gap);
+
+    struct Bitmap
+    {
+        int w, h;
+        std::vector<uint8_t> alpha;
+    };
+
+    std::vector<CookedGlyph> glyphs(glyph_count);
+    std::vector<Bitmap> bitmaps(glyph_count);
+
+    for (int i = 0; i < glyph_count; i++)
+    {
+        const int codepoint = 32 + i;
+        CookedGlyph &glyph = glyphs[i];
+        Bitmap &bitmap = bitmaps[i];
+
+        glyph = CookedGlyph{codepoint, 0, 0, 0, 0, 0, 0, 0};
+        bitmap.w = 0;
+        bitmap.h = 0;
+
+        if (stbtt_FindGlyphIndex(&font_info, codepoint) > 0)
+        {
+            unsigned char *data = stbtt_GetCodepointBitmap(&font_info, scale, scale, codepoint, &bitmap.w, &bitmap.h,
+                                                           &glyph.offset_x, &glyph.offset_y);
+            if (data)
+                bitmap.alpha.assign(data, data + (size_t)bitmap.w * bitmap.h);
+            stbtt_FreeBitmap(data, nullptr);
+
+            int advance;
+            stbtt_GetCodepointHMetrics(&font_info, codepoint, &advance, nullptr);
+            glyph.advance_x = (int)((float)advance * scale);
+
+            glyph.offset_y += (int)((float)ascent * scale);
+        }
+
+        // raylib gives the space an empty image as wide as its advance
+        if (codepoint == ' ' && bitmap.alpha.empty())
+        {
+            bitmap.w = glyph.advance_x;
+            bitmap.h = font_size;
+            bitmap.alpha.assign((size_t)bitmap.w * bitmap.h, 0);
+        }
+    }
+
+    // Pack glyphs into rows, each with padding all around
+    int pen_x = 0, pen_y = 0, row_h = 0;
+    for (int i = 0; i < glyph_count; i++)
+    {
+        int cell_w = bitmaps[i].w + 2 * font_glyph_padding;
+        int cell_h = bitmaps[i].h + 2 * font_glyph_padding;
+
+        if (pen_x + cell_w > font_atlas_width)
+        {
+            pen_x = 0;
+            pen_y += row_h;
+            row_h = 0;
+        }
+
+        glyphs[i].rec_x = (float)(pen_x + font_glyph_padding);
+        glyphs[i].rec_y = (float)(pen_y + font_glyph_padding);
+        glyphs[i].rec_w = (float)bitmaps[i].w;
+        glyphs[i].rec_h = (float)bitmaps[i].h;
+
+        pen_x += cell_w;
+        row_h = std::max(row_h, cell_h);
+    }
+
+    // Power of two height, like raylib's own atlases
+    int atlas_h = 1;
+    while (atlas_h < pen_y + row_h)
+        atlas_h *= 2;
+
+    // Gray+alpha, white glyphs with coverage in alpha (what raylib's font atlases hold)
+    std::vector<uint8_t> atlas((size_t)font_atlas_width * atlas_h * 2, 0);
+    for (size_t i = 0; i < atlas.size(); i += 2)
+        atlas[i] = 255;
+
+    for (int i = 0; i < glyph_count; i++)
+    {
+        for (int y = 0; y < bitmaps[i].h; y++)
+        {
+            for (int x = 0; x < bitmaps[i].w; x++)
+            {
+                size_t dest = ((size_t)(glyphs[i].rec_y + y) * font_atlas_width + (size_t)(glyphs[i].rec_x + x)) * 2;
+                atlas[dest + 1] = bitmaps[i].alpha[(size_t)y * bitmaps[i].w + x];
+            }
+        }
+    }
+
+    std::vector<uint8_t> atlas_png;
+    if (!stbi_write_png_to_func(writeToVector, &atlas_png, font_atlas_width, atlas_h, 2, atlas.data(), font_atlas_width * 2))
+    {
+        std::fprintf(stderr, "%s: could not encode the atlas\n", in);
+        return 1;
+    }
+
+    CookedFontHeader header = {};
+    std::memcpy(header.magic, cooked_font_magic, 4);
+    header.version = cooked_asset_version;
+    header.base_size = font_size;
+    header.glyph_count = glyph_count;
+    header.glyph_padding = font_glyph_padding;
+    header.glyph_offset = sizeof(CookedFontHeader);
+    header.atlas_offset = (uint32_t)(sizeof(CookedFontHeader) + glyphs.size() * sizeof(CookedGlyph));
+    header.atlas_size = (uint32_t)atlas_png.size();
+
+    std::vector<uint8_t> bytes;
+    appendStruct(bytes, header);
+    for (const CookedGlyph &glyph : glyphs)
+        appendStruct(bytes, glyph);
+    bytes.insert(bytes.end(), atlas_png.begin(), atlas_png.end());
+
+    if (!writeFile(out, bytes))
+    {
+        std::fprintf(stderr, "could not write %s\n", out);
+        return 1;
+    }
+
+    std::printf("%s -> %s (%d glyphs at %dpx, %dx%d atlas)\n", in, out, glyph_count, font_size, font_atlas_width, atlas_h);
+    return 0;
+}
+
+// Sounds
+// ======================================================================================
+
+static int cookSoundAsset(const char *in, const char *out)
+{
+    unsigned int channels, sample_rate;
+    drwav_uint64 frames;
+    drwav_int16 *samples = drwav_open_file_and_read_pcm_frames_s16(in, &channels, &sample_rate, &frames, nullptr);
+    if (!samples)
+    {
+        std::fprintf(stderr, "%s: not a WAV file\n", in);
+        return 1;
+    }
+
+    qoa_desc desc = {};
+    desc.channels = channels;
+    desc.samplerate = sample_rate;
+    desc.samples = (unsigned int)frames;
+
+    int size = qoa_write(out, samples, &desc);
+    drwav_free(samples, nullptr);
+
+    if (!size)
+    {
+        std::fprintf(stderr, "could not write %s\n", out);
+        return 1;
+    }
+
+    std::printf("%s -> %s (%d bytes)\n", in, out, size);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    const std::string kind = argc > 1 ? argv[1] : "";
+
+    if (kind == "level" && argc == 4)
+        return cookLevelAsset(argv[2], argv[3]);
+
+    if (kind == "atlas" && argc >= 4)
+        return cookAtlasAsset(argv[2], argv + 3, argc - 3);
+
+    if (kind == "font" && argc == 6)
+        return cookFontAsset(argv[2], argv[3], std::atoi(argv[4]), std::atoi(argv[5]));
+
+    if (kind == "sound" && argc == 4)
+        return cookSoundAsset(argv[2], argv[3]);
+
+    std::fprintf(stderr,
+                 "usage: %s level   <map.json> <out.ctl>\n"
+                 "       %s atlas   <out.cta> <image.png>...\n"
+                 "       %s font    <font.ttf> <out.ctf> <size> <glyphs>\n"
+                 "       %s sound   <sound.wav> <out.qoa>\n",
+                 argv[0], argv[0], argv[0], argv[0]);
+    return 2;
+}
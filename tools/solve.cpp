@@ -0,0 +1,139 @@
+// Level solver
+//
+// Finds the shortest route from spawn to the finish of a Tiled JSON level, prints the minimal move
+// count and par time, and checks the route by playing it through the game's simulation.
+//
+// Usage: cattower_solve <map.json> [--all-checkpoints] [--route] [--seconds-per-move <s>] [--record <replay.ctr>]
+//
+// --record writes the route as a replay (one slide per tick), eg. as a reference run for cattower_verify.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "core/Level.hpp"
+#include "core/SlideGraph.hpp"
+#include "core/Solver.hpp"
+#include "core/Simulation.hpp"
+#include "core/Replay.hpp"
+
+static const char *inputName(SimInput input)
+{
+    switch (input)
+    {
+    case SimInput_Left:
+        return "left";
+    case SimInput_Right:
+        return "right";
+    case SimInput_Up:
+        return "up";
+    case SimInput_Down:
+        return "down";
+    default:
+        return "?";
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = nullptr;
+    bool print_route = false;
+    const char *record_path = nullptr;
+    SolverOptions options;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--all-checkpoints") == 0)
+            options.visit_all_checkpoints = true;
+        else if (std::strcmp(argv[i], "--route") == 0)
+            print_route = true;
+        else if (std::strcmp(argv[i], "--seconds-per-move") == 0 && i + 1 < argc)
+            options.seconds_per_move = (float)std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            record_path = argv[++i];
+        else
+            path = argv[i];
+    }
+
+    if (!path)
+    {
+        std::fprintf(stderr, "usage: %s <map.json> [--all-checkpoints] [--route] [--seconds-per-move <s>] [--record <replay.ctr>]\n", argv[0]);
+        return 2;
+    }
+
+    Level level;
+    if (!loadLevel(path, level))
+    {
+        std::fprintf(stderr, "could not load %s\n", path);
+        return 2;
+    }
+
+    // Build and solve
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    SlideGraph graph;
+    graph.build(level);
+    std::chrono::steady_clock::time_point built = std::chrono::steady_clock::now();
+
+    Solution solution = solveLevel(graph, level.spawn_pos, options);
+    std::chrono::steady_clock::time_point solved = std::chrono::steady_clock::now();
+
+    std::printf("%s: %dx%d cells, %d checkpoints\n", path, graph.width(), graph.height(), graph.getCheckpointCount());
+    std::printf("graph %.2f ms, search %.2f ms (%zu states)\n",
+                std::chrono::duration<double, std::milli>(built - start).count(),
+                std::chrono::duration<double, std::milli>(solved - built).count(),
+                solution.states_explored);
+
+    if (!solution.solved)
+    {
+        std::printf("unsolvable: %s\n", solution.message.c_str());
+        return 1;
+    }
+
+    std::printf("moves %u, par %.2fs, touches %d/%d checkpoints\n",
+                solution.moves, solution.par_time, solution.checkpoints_visited, graph.getCheckpointCount());
+
+    if (print_route)
+    {
+        for (size_t i = 0; i < solution.inputs.size(); i++)
+            std::printf("%4zu  %-5s -> (%d, %d)\n", i + 1, inputName(solution.inputs[i]), solution.path[i].x, solution.path[i].y);
+    }
+
+    // Play the route through the real rules to make sure it wins
+    Simulation sim;
+    if (!sim.load(level))
+    {
+        std::printf("route can't be simulated, level has no spawn\n");
+        return 1;
+    }
+
+    uint8_t events = SimEvent_None;
+    for (SimInput input : solution.inputs)
+        events = sim.step(input);
+
+    if (!(events & SimEvent_Finished))
+    {
+        std::printf("route does NOT finish when simulated\n");
+        return 1;
+    }
+
+    std::printf("verified in simulation (%u ticks)\n", sim.getTicks());
+
+    // Save the route as a replay
+    if (record_path)
+    {
+        Replay replay = {hashLevel(level), {}, (uint32_t)solution.inputs.size()};
+        for (size_t i = 0; i < solution.inputs.size(); i++)
+            replay.inputs.push_back(ReplayInput{(uint32_t)i, solution.inputs[i]});
+
+        if (!saveReplay(record_path, replay))
+        {
+            std::fprintf(stderr, "could not write %s\n", record_path);
+            return 2;
+        }
+        std::printf("route written to %s\n", record_path);
+    }
+
+    return 0;
+}
@@ -0,0 +1,189 @@
+// Level validator
+//
+// Loads Tiled JSON levels through the game's own loader, builds each one's slide graph and reports
+// softlocks (cells the finish can't be reached from), unreachable checkpoints and forced deaths.
+// Levels are validated in parallel, one per worker thread.
+//
+// Usage: cattower_validate <map.json | folder>... [-j threads] [-v]
+// Exits with 1 if any level has errors (no spawn, finish unreachable or a checkpoint unreachable).
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/Level.hpp"
+#include "core/SlideGraph.hpp"
+#include "core/LevelAnalysis.hpp"
+
+struct LevelResult
+{
+    std::string text;
+    bool loaded;
+    bool errors;
+    bool warnings;
+};
+
+// How many example cells to print per problem unless -v is given
+static const size_t max_examples = 5;
+
+static void printCells(std::stringstream &out, const std::vector<Vector2i> &cells, bool verbose)
+{
+    size_t count = verbose ? cells.size() : std::min(cells.size(), max_examples);
+    for (size_t i = 0; i < count; i++)
+        out << " (" << cells[i].x << ", " << cells[i].y << ")";
+    if (count < cells.size())
+        out << " ...";
+}
+
+// Validate one level, formatting its report
+static LevelResult validate(const std::string &path, bool verbose)
+{
+    LevelResult result = {"", false, false, false};
+    std::stringstream out;
+
+    Level level;
+    if (!loadLevel(path.c_str(), level))
+    {
+        result.text = path + ": ERROR could not load\n";
+        result.errors = true;
+        return result;
+    }
+    result.loaded = true;
+
+    SlideGraph graph;
+    graph.build(level);
+    LevelReport report = analyzeLevel(graph, level.spawn_pos);
+
+    result.errors = report.hasErrors();
+    result.warnings = report.hasWarnings();
+
+    out << path << ": " << (result.errors ? "ERROR" : result.warnings ? "WARN" : "OK")
+        << "  (" << graph.width() << "x" << graph.height() << ", " << report.reachable_cells << " reachable cells, "
+        << report.component_count << " components, " << graph.getCheckpointCount() << " checkpoints)\n";
+
+    if (!report.has_spawn)
+    {
+        out << "  no spawn\n";
+        result.text = out.str();
+        return result;
+    }
+
+    if (!report.finish_reachable)
+        out << "  finish is unreachable from spawn\n";
+
+    if (!report.unreachable_checkpoints.empty())
+    {
+        out << "  " << report.unreachable_checkpoints.size() << " unreachable checkpoint(s):";
+        printCells(out, report.unreachable_checkpoints, verbose);
+        out << "\n";
+    }
+
+    if (!report.softlocks.empty())
+    {
+        out << "  softlock: " << report.softlock_cells << " cell(s) in " << report.softlocks.size()
+            << " region(s) can't reach the finish without a reset:";
+
+        std::vector<Vector2i> examples;
+        for (const TrapRegion &region : report.softlocks)
+            examples.push_back(region.cell);
+        printCells(out, examples, verbose);
+        out << "\n";
+    }
+
+    if (!report.death_traps.empty())
+    {
+        out << "  " << report.death_traps.size() << " cell(s) where every slide hits damage:";
+        printCells(out, report.death_traps, verbose);
+        out << "\n";
+    }
+
+    result.text = out.str();
+    return result;
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<std::string> paths;
+    unsigned thread_count = std::max(1u, std::thread::hardware_concurrency());
+    bool verbose = false;
+
+    // Collect levels from arguments (folders are searched for .json maps)
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+        {
+            thread_count = std::max(1, std::atoi(argv[++i]));
+            continue;
+        }
+        if (std::strcmp(argv[i], "-v") == 0)
+        {
+            verbose = true;
+            continue;
+        }
+
+        std::filesystem::path arg = argv[i];
+        if (std::filesystem::is_directory(arg))
+        {
+            for (const auto &entry : std::filesystem::recursive_directory_iterator(arg))
+            {
+                if (entry.is_regular_file() && entry.path().extension() == ".json")
+                    paths.push_back(entry.path().string());
+            }
+        }
+        else
+        {
+            paths.push_back(arg.string());
+        }
+    }
+
+    if (paths.empty())
+    {
+        std::fprintf(stderr, "usage: %s <map.json | folder>... [-j threads] [-v]\n", argv[0]);
+        return 2;
+    }
+    std::sort(paths.begin(), paths.end());
+
+    // Validate in parallel, each worker taking the next unclaimed level
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    std::vector<LevelResult> results(paths.size());
+    std::atomic<size_t> next_level(0);
+
+    std::vector<std::thread> workers;
+    thread_count = (unsigned)std::min<size_t>(thread_count, paths.size());
+    for (unsigned t = 0; t < thread_count; t++)
+    {
+        workers.emplace_back([&]()
+                             {
+                                 for (size_t i = next_level++; i < paths.size(); i = next_level++)
+                                     results[i] = validate(paths[i], verbose); //
+                             });
+    }
+    for (std::thread &worker : workers)
+        worker.join();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Report in a stable order
+    int errors = 0;
+    int warnings = 0;
+    for (const LevelResult &result : results)
+    {
+        std::fputs(result.text.c_str(), stdout);
+        errors += result.errors;
+        warnings += result.warnings && !result.errors;
+    }
+
+    std::printf("%zu level(s), %d with errors, %d with warnings (%.1f ms on %u threads)\n",
+                paths.size(), errors, warnings, seconds * 1000.0, thread_count);
+
+    return errors > 0 ? 1 : 0;
+}
@@ -0,0 +1,154 @@
+// Batch replay verifier
+//
+// Re-simulates every replay in a folder against a level with the game's own rules, in parallel on a
+// work-stealing thread pool. Prints whether each run is valid (recorded on this level and reaches the
+// finish inside the time limit) with its tick-exact time, then the overall throughput.
+//
+// Usage: cattower_verify <map.json> <replay folder | replay.ctr>... [-j threads] [--time-limit <s>]
+// Exits with 1 if any replay is invalid.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "core/Level.hpp"
+#include "core/Simulation.hpp"
+#include "core/Replay.hpp"
+
+#include "WorkStealingPool.hpp"
+
+// Same time limit the game gives a run
+static const float default_time_limit = 560.f;
+
+struct RunResult
+{
+    // Why the run is invalid (nullptr if it's valid)
+    const char *problem;
+    uint32_t time_ticks;
+};
+
+int main(int argc, char **argv)
+{
+    const char *level_path = nullptr;
+    std::vector<std::string> replay_paths;
+    unsigned thread_count = std::max(1u, std::thread::hardware_concurrency());
+    float time_limit = default_time_limit;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+        {
+            thread_count = std::max(1, std::atoi(argv[++i]));
+            continue;
+        }
+        if (std::strcmp(argv[i], "--time-limit") == 0 && i + 1 < argc)
+        {
+            time_limit = (float)std::atof(argv[++i]);
+            continue;
+        }
+        if (!level_path)
+        {
+            level_path = argv[i];
+            continue;
+        }
+
+        std::filesystem::path arg = argv[i];
+        if (std::filesystem::is_directory(arg))
+        {
+            for (const auto &entry : std::filesystem::recursive_directory_iterator(arg))
+            {
+                if (entry.is_regular_file() && entry.path().extension() == ".ctr")
+                    replay_paths.push_back(entry.path().string());
+            }
+        }
+        else
+        {
+            replay_paths.push_back(arg.string());
+        }
+    }
+
+    if (!level_path || replay_paths.empty())
+    {
+        std::fprintf(stderr, "usage: %s <map.json> <replay folder | replay.ctr>... [-j threads] [--time-limit <s>]\n", argv[0]);
+        return 2;
+    }
+    std::sort(replay_paths.begin(), replay_paths.end());
+
+    Level level;
+    if (!loadLevel(level_path, level))
+    {
+        std::fprintf(stderr, "could not load %s\n", level_path);
+        return 2;
+    }
+    const uint64_t level_hash = hashLevel(level);
+
+    WorkStealingPool pool(thread_count);
+
+    // One simulation per worker, loaded once and reset between replays
+    std::vector<Simulation> sims(pool.size());
+    for (Simulation &sim : sims)
+    {
+        sim.setTimeLimit(time_limit);
+        if (!sim.load(level))
+        {
+            std::fprintf(stderr, "%s has no spawn\n", level_path);
+            return 2;
+        }
+    }
+
+    // Verify every replay
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    std::vector<RunResult> results(replay_paths.size());
+    pool.run(replay_paths.size(), [&](size_t worker, size_t task)
+             {
+                 RunResult &result = results[task];
+                 result = RunResult{nullptr, 0};
+
+                 Replay replay;
+                 if (!loadReplay(replay_paths[task], replay))
+                 {
+                     result.problem = "unreadable";
+                     return;
+                 }
+
+                 PlaybackResult playback = playReplay(sims[worker], level_hash, replay);
+                 result.time_ticks = playback.time_ticks;
+
+                 if (!playback.level_matches)
+                     result.problem = "recorded on a different level";
+                 else if (playback.timed_out)
+                     result.problem = "runs out of time";
+                 else if (!playback.finished)
+                     result.problem = "does not finish";
+             });
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Report
+    size_t invalid = 0;
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const RunResult &result = results[i];
+        if (result.problem)
+        {
+            invalid++;
+            std::printf("INVALID  %s (%s)\n", replay_paths[i].c_str(), result.problem);
+        }
+        else
+        {
+            std::printf("valid    %s  %u ticks (%.3fs)\n", replay_paths[i].c_str(), result.time_ticks,
+                        (double)result.time_ticks / Simulation::tick_rate);
+        }
+    }
+
+    std::printf("%zu replay(s), %zu invalid, %.1f ms on %zu threads (%.0f replays/sec)\n",
+                results.size(), invalid, seconds * 1000.0, pool.size(), results.size() / seconds);
+
+    return invalid > 0 ? 1 : 0;
+}